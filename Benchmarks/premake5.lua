@@ -0,0 +1,41 @@
+project "Benchmarks"
+    kind "ConsoleApp"
+    language "C++"
+    targetdir ("../bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("../bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files
+    {
+        "src/**.h",
+        "src/**.cpp",
+        "../Swindow.h",
+    }
+
+    filter "system:windows"
+    systemversion "latest"
+    defines
+    {
+        "SW_PLATFORM_WINDOWS"
+    }
+    links
+    {
+        "opengl32",
+    }
+
+    filter "system:linux"
+    links
+    {
+        "X11",
+        "GL",
+        "EGL",
+        "dl",
+        "pthread",
+    }
+
+    filter "configurations:Debug"
+        defines { "SWINDOW_DEBUG" }
+        symbols "On"
+
+    filter "configurations:Release"
+        defines { "SWINDOW_RELEASE" }
+        optimize "On"
@@ -0,0 +1,177 @@
+/*
+ * Replaces every global operator new, plain, array, nothrow and aligned, so benchmarks can check that a code path does not allocate.
+ * Only C++ allocations are seen: memory the OpenGL driver or the C library gets from malloc is not counted.
+ */
+
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace SwindowBenchmarks
+{
+	static thread_local bool t_IsCounting = false;
+	static thread_local uint64_t t_AllocationCount = 0;
+
+	void BeginCountingAllocations()
+	{
+		t_AllocationCount = 0;
+		t_IsCounting = true;
+	}
+
+	uint64_t EndCountingAllocations()
+	{
+		t_IsCounting = false;
+		return t_AllocationCount;
+	}
+
+	static void* Allocate(std::size_t size) noexcept
+	{
+		if (t_IsCounting)
+		{
+			t_AllocationCount++;
+		}
+		return std::malloc(size ? size : 1);
+	}
+
+#ifdef __cpp_aligned_new
+	static void* AllocateAligned(std::size_t size, std::align_val_t alignment) noexcept
+	{
+		if (t_IsCounting)
+		{
+			t_AllocationCount++;
+		}
+
+		const std::size_t bytes = size ? size : 1;
+#ifdef _WIN32
+		return _aligned_malloc(bytes, static_cast<std::size_t>(alignment));
+#else
+		void* memory = nullptr;
+		const std::size_t minimum = sizeof(void*);
+		const std::size_t align = static_cast<std::size_t>(alignment) < minimum ? minimum : static_cast<std::size_t>(alignment);
+		return posix_memalign(&memory, align, bytes) == 0 ? memory : nullptr;
+#endif
+	}
+
+	static void FreeAligned(void* memory) noexcept
+	{
+#ifdef _WIN32
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+#endif
+}//Namespace SwindowBenchmarks
+
+void* operator new(std::size_t size)
+{
+	void* memory = SwindowBenchmarks::Allocate(size);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return SwindowBenchmarks::Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return SwindowBenchmarks::Allocate(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* memory = SwindowBenchmarks::AllocateAligned(size, alignment);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return SwindowBenchmarks::AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return SwindowBenchmarks::AllocateAligned(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	SwindowBenchmarks::FreeAligned(memory);
+}
+#endif
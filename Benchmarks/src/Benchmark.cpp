@@ -0,0 +1,111 @@
+﻿/*
+ * Benchmark harness: runs each benchmark several times and reports nanoseconds per operation.
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+
+namespace SwindowBenchmarks
+{
+	Result RunBenchmark(const Benchmark& benchmark, size_t runs)
+	{
+		Result result;
+		result.Name = benchmark.Name;
+		result.Operations = benchmark.Operations;
+
+		try
+		{
+			if (benchmark.Setup)
+			{
+				benchmark.Setup();
+			}
+
+			// The first run warms caches, drivers and lazily created state and is not reported
+			benchmark.Run();
+
+			std::vector<double> samples;
+			samples.reserve(runs);
+			for (size_t i = 0; i < runs; i++)
+			{
+				samples.push_back(static_cast<double>(benchmark.Run()) / static_cast<double>(benchmark.Operations));
+			}
+
+			if (benchmark.Teardown)
+			{
+				benchmark.Teardown();
+			}
+
+			std::sort(samples.begin(), samples.end());
+			result.Runs = samples.size();
+			result.Min = samples.front();
+			result.Median = samples[samples.size() / 2];
+			result.Max = samples.back();
+		}
+		catch (const std::exception& exception)
+		{
+			result.Error = exception.what();
+
+			// Release the fixture anyway, e.g. a window whose event thread would otherwise outlive main
+			if (benchmark.Teardown)
+			{
+				try
+				{
+					benchmark.Teardown();
+				}
+				catch (const std::exception&)
+				{
+				}
+			}
+		}
+
+		return result;
+	}
+
+	bool WriteResults(const std::vector<Result>& results, const std::string& path)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			return false;
+		}
+
+#ifdef _WIN32
+		const char* platform = "windows";
+#else
+		const char* platform = "linux";
+#endif
+
+		std::fprintf(file, "{\n\t\"platform\": \"%s\",\n\t\"backend\": \"%s\",\n\t\"benchmarks\": [",
+			platform, GetOptions().Native ? "native" : "headless");
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const Result& result = results[i];
+			std::fprintf(file, "%s\n\t\t{ \"name\": \"%s\", ", i == 0 ? "" : ",", result.Name.c_str());
+
+			if (!result.Error.empty())
+			{
+				std::string error;
+				for (char c : result.Error)
+				{
+					if (c == '"' || c == '\\')
+						error += '\\';
+					error += c;
+				}
+
+				std::fprintf(file, "\"error\": \"%s\" }", error.c_str());
+				continue;
+			}
+
+			std::fprintf(file, "\"operations\": %llu, \"runs\": %zu, \"ns_per_op\": { \"min\": %.3f, \"median\": %.3f, \"max\": %.3f }, \"ops_per_second\": %.1f }",
+				static_cast<unsigned long long>(result.Operations), result.Runs, result.Min, result.Median, result.Max, 1e9 / result.Median);
+		}
+
+		std::fprintf(file, "\n\t]\n}\n");
+		std::fclose(file);
+		return true;
+	}
+}//Namespace SwindowBenchmarks
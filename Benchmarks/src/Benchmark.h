@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SwindowBenchmarks
+{
+	// Measures `Operations` operations and returns the elapsed nanoseconds.
+	// Setup and Teardown run outside the measured time, once per benchmark.
+	struct Benchmark
+	{
+		std::string Name;
+		uint64_t Operations;
+		std::function<void()> Setup;
+		std::function<uint64_t()> Run;
+		std::function<void()> Teardown;
+	};
+
+	// Nanoseconds per operation across the measured runs
+	struct Result
+	{
+		std::string Name;
+		uint64_t Operations = 0;
+		size_t Runs = 0;
+		double Min = 0.0;
+		double Median = 0.0;
+		double Max = 0.0;
+		std::string Error; // Set if the benchmark threw, e.g. when no display is available
+	};
+
+	struct Options
+	{
+		bool Native = false; // Use the platform window instead of the headless backend (run under Xvfb on CI)
+		size_t Runs = 7;
+		std::string Filter; // Only run benchmarks whose name contains this
+		std::string OutputPath = "BenchmarkResults.json";
+	};
+
+	const Options& GetOptions();
+
+	// Registers every benchmark in the suite
+	std::vector<Benchmark> CreateBenchmarks();
+
+	Result RunBenchmark(const Benchmark& benchmark, size_t runs);
+
+	// Writes the results as JSON so runs can be compared between releases
+	bool WriteResults(const std::vector<Result>& results, const std::string& path);
+
+	// Counts the C++ allocations made by the calling thread in between, see Allocations.cpp
+	void BeginCountingAllocations();
+	uint64_t EndCountingAllocations();
+}//Namespace SwindowBenchmarks
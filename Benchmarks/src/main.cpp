@@ -0,0 +1,1031 @@
+/*
+ * Swindow benchmark suite.
+ *
+ * Usage: Benchmarks [--native] [--runs N] [--filter text] [--output path]
+ *
+ * Runs on the headless backend by default. Pass --native to benchmark the platform window, e.g. under Xvfb.
+ * Benchmarks that send events through the OS also run whenever a display is available.
+ * Results are written as JSON to --output (BenchmarkResults.json by default) and summarised on stdout.
+ * A benchmark that also checks behaviour, e.g. for a lost wakeup or an allocation, throws to fail the run.
+ */
+
+#include "Benchmark.h"
+
+#include "../../Swindow.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace SwindowBenchmarks
+{
+	using namespace Swindow;
+	using Swindow::Window;
+	using Swindow::KeyCode;
+
+	static Options g_Options;
+	static WindowPtr g_Window;
+
+	// Keeps the compiler from discarding benchmarked work
+	static volatile uint64_t g_Sink;
+
+	const Options& GetOptions()
+	{
+		return g_Options;
+	}
+
+	// egl selects the EGL context path for native X11 windows; headless windows always use EGL
+	static WindowDescription MakeDescription(bool egl = false)
+	{
+		WindowDescription description;
+		description.Title = "Swindow Benchmarks";
+		description.Width = 1280;
+		description.Height = 720;
+		description.Headless = !g_Options.Native;
+		description.UseEGL = egl;
+		return description;
+	}
+
+	// Fixture shared by the benchmarks that need a window with a context
+	static std::function<void()> CreateWindowWithContext(bool legacy, bool egl = false)
+	{
+		return [legacy, egl]()
+			{
+				g_Window = Window::Create(MakeDescription(egl));
+				g_Window->CreateContext(legacy ? 2 : 3, legacy ? 1 : 3, legacy);
+				g_Window->SetSwapInterval(0);
+			};
+	}
+
+	// Also runs after a failed benchmark, when setup may not have created the window
+	static void DestroyWindow()
+	{
+		if (g_Window)
+		{
+			g_Window->Destroy();
+			g_Window = nullptr;
+		}
+	}
+
+	static uint64_t BenchmarkCreateDestroy(uint64_t operations)
+	{
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			WindowPtr window = Window::Create(MakeDescription());
+			window->Destroy();
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	static uint64_t BenchmarkCreateContext(uint64_t operations, bool legacy, bool egl = false)
+	{
+		uint64_t elapsed = 0;
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			WindowPtr window = Window::Create(MakeDescription(egl));
+
+			const uint64_t start = Window::GetTime();
+			window->CreateContext(legacy ? 2 : 3, legacy ? 1 : 3, legacy);
+			elapsed += Window::GetTime() - start;
+
+			window->Destroy();
+		}
+
+		return elapsed;
+	}
+
+	// Resolves the whole function table from scratch, as the first context of a driver does
+	static uint64_t BenchmarkLoadGLFunctions(uint64_t operations)
+	{
+		uint64_t sum = 0;
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			Internal::GLFunctions functions;
+			sum += functions.Load(*g_Window) ? 1 : 0;
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		g_Sink = sum;
+		return elapsed;
+	}
+
+	// Fetches the table from the cache, as every further context of the same driver does
+	static uint64_t BenchmarkAcquireGLFunctions(uint64_t operations)
+	{
+		uint64_t sum = 0;
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			sum += reinterpret_cast<uintptr_t>(&Internal::AcquireGLFunctions(*g_Window));
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		g_Sink = sum;
+		return elapsed;
+	}
+
+	// The translation the lookup tables replaced: an unordered_map built on every call. Kept as the baseline.
+	static KeyCode TranslateKeyWithMap(int key)
+	{
+#ifdef _WIN32
+		const std::unordered_map<int, KeyCode> keyMap = {
+			{ 'A', KeyCode::A }, { 'B', KeyCode::B }, { 'C', KeyCode::C }, { 'D', KeyCode::D },
+			{ 'E', KeyCode::E }, { 'F', KeyCode::F }, { 'G', KeyCode::G }, { 'H', KeyCode::H },
+			{ 'I', KeyCode::I }, { 'J', KeyCode::J }, { 'K', KeyCode::K }, { 'L', KeyCode::L },
+			{ 'M', KeyCode::M }, { 'N', KeyCode::N }, { 'O', KeyCode::O }, { 'P', KeyCode::P },
+			{ 'Q', KeyCode::Q }, { 'R', KeyCode::R }, { 'S', KeyCode::S }, { 'T', KeyCode::T },
+			{ 'U', KeyCode::U }, { 'V', KeyCode::V }, { 'W', KeyCode::W }, { 'X', KeyCode::X },
+			{ 'Y', KeyCode::Y }, { 'Z', KeyCode::Z },
+
+			{ VK_ESCAPE, KeyCode::Escape }, { VK_RETURN, KeyCode::Enter },
+			{ VK_SPACE, KeyCode::Space }, { VK_BACK, KeyCode::Backspace },
+			{ VK_TAB, KeyCode::Tab }, { VK_SHIFT, KeyCode::Shift },
+			{ VK_CONTROL, KeyCode::Ctrl }, { VK_MENU, KeyCode::Alt },
+
+			{ VK_LEFT, KeyCode::Left }, { VK_RIGHT, KeyCode::Right },
+			{ VK_UP, KeyCode::Up }, { VK_DOWN, KeyCode::Down },
+
+			{ VK_F1, KeyCode::F1 }, { VK_F2, KeyCode::F2 }, { VK_F3, KeyCode::F3 },
+			{ VK_F4, KeyCode::F4 }, { VK_F5, KeyCode::F5 }, { VK_F6, KeyCode::F6 },
+			{ VK_F7, KeyCode::F7 }, { VK_F8, KeyCode::F8 }, { VK_F9, KeyCode::F9 },
+			{ VK_F10, KeyCode::F10 }, { VK_F11, KeyCode::F11 }, { VK_F12, KeyCode::F12 }
+		};
+#else
+		const std::unordered_map<int, KeyCode> keyMap = {
+			{ XK_a, KeyCode::A }, { XK_b, KeyCode::B }, { XK_c, KeyCode::C }, { XK_d, KeyCode::D },
+			{ XK_e, KeyCode::E }, { XK_f, KeyCode::F }, { XK_g, KeyCode::G }, { XK_h, KeyCode::H },
+			{ XK_i, KeyCode::I }, { XK_j, KeyCode::J }, { XK_k, KeyCode::K }, { XK_l, KeyCode::L },
+			{ XK_m, KeyCode::M }, { XK_n, KeyCode::N }, { XK_o, KeyCode::O }, { XK_p, KeyCode::P },
+			{ XK_q, KeyCode::Q }, { XK_r, KeyCode::R }, { XK_s, KeyCode::S }, { XK_t, KeyCode::T },
+			{ XK_u, KeyCode::U }, { XK_v, KeyCode::V }, { XK_w, KeyCode::W }, { XK_x, KeyCode::X },
+			{ XK_y, KeyCode::Y }, { XK_z, KeyCode::Z },
+
+			{ XK_0, KeyCode::Num0 }, { XK_1, KeyCode::Num1 }, { XK_2, KeyCode::Num2 }, { XK_3, KeyCode::Num3 },
+			{ XK_4, KeyCode::Num4 }, { XK_5, KeyCode::Num5 }, { XK_6, KeyCode::Num6 }, { XK_7, KeyCode::Num7 },
+			{ XK_8, KeyCode::Num8 }, { XK_9, KeyCode::Num9 },
+
+			{ XK_Escape, KeyCode::Escape }, { XK_Return, KeyCode::Enter },
+			{ XK_space, KeyCode::Space }, { XK_BackSpace, KeyCode::Backspace },
+			{ XK_Tab, KeyCode::Tab }, { XK_Shift_L, KeyCode::Shift },
+			{ XK_Shift_R, KeyCode::Shift }, { XK_Control_L, KeyCode::Ctrl },
+			{ XK_Control_R, KeyCode::Ctrl }, { XK_Alt_L, KeyCode::Alt },
+			{ XK_Alt_R, KeyCode::Alt },
+
+			{ XK_Left, KeyCode::Left }, { XK_Right, KeyCode::Right },
+			{ XK_Up, KeyCode::Up }, { XK_Down, KeyCode::Down },
+
+			{ XK_F1, KeyCode::F1 }, { XK_F2, KeyCode::F2 }, { XK_F3, KeyCode::F3 },
+			{ XK_F4, KeyCode::F4 }, { XK_F5, KeyCode::F5 }, { XK_F6, KeyCode::F6 },
+			{ XK_F7, KeyCode::F7 }, { XK_F8, KeyCode::F8 }, { XK_F9, KeyCode::F9 },
+			{ XK_F10, KeyCode::F10 }, { XK_F11, KeyCode::F11 }, { XK_F12, KeyCode::F12 }
+		};
+#endif
+		auto it = keyMap.find(key);
+		return (it != keyMap.end()) ? it->second : KeyCode::Unknown;
+	}
+
+	// useMap selects the per-call unordered_map baseline instead of the backend's lookup table
+	static uint64_t BenchmarkKeyTranslation(uint64_t operations, bool useMap)
+	{
+		// A spread of native keys covering letters, digits, function keys and unmapped values
+#ifdef _WIN32
+		static const int nativeKeys[] = { 'A', 'Z', '0', '9', VK_SPACE, VK_RETURN, VK_ESCAPE, VK_F1, VK_F12, VK_LEFT, VK_NUMPAD5, VK_LSHIFT, 0xFF, 0x07, VK_OEM_1, VK_TAB };
+#else
+		static const int nativeKeys[] = { XK_a, XK_z, XK_0, XK_9, XK_space, XK_Return, XK_Escape, XK_F1, XK_F12, XK_Left, XK_KP_5, XK_Shift_L, XK_eacute, 0x1008FF11, XK_semicolon, XK_Tab };
+#endif
+		constexpr size_t keyCount = sizeof(nativeKeys) / sizeof(nativeKeys[0]);
+
+		uint64_t sum = 0;
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			const int key = nativeKeys[i % keyCount];
+			if (useMap)
+			{
+				sum += static_cast<uint64_t>(TranslateKeyWithMap(key));
+				continue;
+			}
+
+#ifdef _WIN32
+			sum += static_cast<uint64_t>(Internal::Win32NativeWindow::TranslateKey(key));
+#else
+			sum += static_cast<uint64_t>(Internal::X11NativeWindow::TranslateKey(key));
+#endif
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		g_Sink = sum;
+		return elapsed;
+	}
+
+	static std::vector<Event> g_Events;
+
+	// A window whose callbacks do minimal work, plus a stream of mixed input events
+	static void CreateEventWindow()
+	{
+		g_Window = Window::Create(MakeDescription());
+		g_Window->SetWindowKeyCallback([](KeyCode key, bool isPressed) { g_Sink = g_Sink + static_cast<uint64_t>(key); });
+		g_Window->SetWindowMouseCallback([](MouseButton button, bool isPressed) { g_Sink = g_Sink + static_cast<uint64_t>(button); });
+		g_Window->SetWindowMouseMoveCallback([](int x, int y) { g_Sink = g_Sink + static_cast<uint64_t>(x + y); });
+		g_Window->SetWindowCharacterCallback([](char character) { g_Sink = g_Sink + static_cast<uint64_t>(character); });
+
+		g_Events.clear();
+		for (int i = 0; i < 4096; i++)
+		{
+			switch (i % 8)
+			{
+			case 0: g_Events.push_back(Event::MakeKey(KeyCode::A, true)); break;
+			case 1: g_Events.push_back(Event::MakeCharacter('a')); break;
+			case 2: g_Events.push_back(Event::MakeKey(KeyCode::A, false)); break;
+			case 3: g_Events.push_back(Event::MakeMouseButton(MouseButton::LeftMouseButton, (i & 8) != 0)); break;
+			default: g_Events.push_back(Event::MakeMouseMove(i % 1280, i % 720)); break;
+			}
+		}
+	}
+
+	static uint64_t BenchmarkInjectEvent(uint64_t operations)
+	{
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			if (i % g_Events.size() == 0)
+			{
+				// Start a new frame so the motion history does not grow without bound
+				g_Window->PollEvents();
+			}
+
+			g_Window->InjectEvent(g_Events[i % g_Events.size()]);
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	static uint64_t BenchmarkInjectEventsBatched(uint64_t operations)
+	{
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i += g_Events.size())
+		{
+			g_Window->PollEvents();
+			g_Window->InjectEvents(g_Events.data(), g_Events.size());
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	// The event window with motion coalescing, so every injected motion event also goes into the motion history ring
+	static void CreateCoalescingEventWindow()
+	{
+		CreateEventWindow();
+		g_Window->SetMouseMotionCoalescing(true);
+	}
+
+	static uint64_t g_ReceivedEvents;
+
+	// A headless window whose events are forwarded by an event thread, counting what reaches the callbacks
+	static void CreateEventThreadWindow()
+	{
+		WindowDescription description = MakeDescription();
+		description.EventThread = true;
+
+		g_Window = Window::Create(description);
+		g_Window->SetWindowKeyCallback([](KeyCode key, bool isPressed) { g_ReceivedEvents++; });
+	}
+
+	// Stress run: another thread posts events in bursts of varying length while this thread waits without a
+	// timeout, so every burst ends with the render thread about to sleep just as the event thread pushes.
+	// A lost wakeup would block forever; the poster notices, unblocks the wait and the benchmark fails.
+	static uint64_t BenchmarkEventThreadWakeup(uint64_t operations)
+	{
+		g_ReceivedEvents = 0;
+		std::atomic<bool> isFinished{ false };
+		std::atomic<bool> isStuck{ false };
+
+		const uint64_t start = Window::GetTime();
+		std::thread poster([operations, &isFinished, &isStuck]()
+			{
+				for (uint64_t i = 0; i < operations; i++)
+				{
+					g_Window->PostEvent(Event::MakeKey(KeyCode::A, (i & 1) == 0));
+					if (i % 7 == (i / 7) % 5)
+					{
+						std::this_thread::sleep_for(std::chrono::microseconds(i % 3 * 20));
+					}
+				}
+
+				const uint64_t deadline = Window::GetTime() + 5000000000ull;
+				while (!isFinished && Window::GetTime() < deadline)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+
+				if (!isFinished)
+				{
+					isStuck = true;
+					g_Window->PostEmptyEvent();
+				}
+			});
+
+		while (g_ReceivedEvents < operations && !isStuck)
+		{
+			g_Window->WaitEvents();
+		}
+		isFinished = true;
+		poster.join();
+
+		const uint64_t elapsed = Window::GetTime() - start;
+		if (isStuck)
+		{
+			throw std::runtime_error("WaitEvents missed a wakeup with " + std::to_string(operations - g_ReceivedEvents) + " events pending");
+		}
+
+		return elapsed;
+	}
+
+#ifndef _WIN32
+	// A second connection to the X server, the way another client would send the window events
+	static Display* g_SendDisplay;
+#endif
+
+	// Whether native windows can be created without --native, so the native paths are covered whenever possible
+	static bool HasDisplay()
+	{
+#ifdef _WIN32
+		return true;
+#else
+		const char* display = std::getenv("DISPLAY");
+		return display && display[0] != '\0';
+#endif
+	}
+
+	static void OpenSendDisplay()
+	{
+#ifndef _WIN32
+		g_SendDisplay = XOpenDisplay(nullptr);
+		if (!g_SendDisplay)
+		{
+			throw std::runtime_error("Failed to open a second X display connection");
+		}
+#endif
+	}
+
+	static void CloseSendDisplay()
+	{
+#ifndef _WIN32
+		if (g_SendDisplay)
+		{
+			XCloseDisplay(g_SendDisplay);
+			g_SendDisplay = nullptr;
+		}
+#endif
+	}
+
+	// Sends a mouse move to the window through the X server or the Win32 message queue
+	static void SendNativeMouseMove(int x, int y)
+	{
+		const uintptr_t handle = g_Window->GetNativeHandle();
+#ifdef _WIN32
+		PostMessage(reinterpret_cast<HWND>(handle), WM_MOUSEMOVE, 0, MAKELPARAM(x, y));
+#else
+		XEvent event = {};
+		event.xmotion.type = MotionNotify;
+		event.xmotion.window = static_cast<::Window>(handle);
+		event.xmotion.x = x;
+		event.xmotion.y = y;
+		XSendEvent(g_SendDisplay, event.xmotion.window, False, 0, &event);
+		XFlush(g_SendDisplay);
+#endif
+	}
+
+	// Sends a press or release of the A key, which also produces a character on press
+	static void SendNativeKey(bool isPressed)
+	{
+		const uintptr_t handle = g_Window->GetNativeHandle();
+#ifdef _WIN32
+		PostMessage(reinterpret_cast<HWND>(handle), isPressed ? WM_KEYDOWN : WM_KEYUP, 'A', 0);
+		if (isPressed)
+		{
+			PostMessage(reinterpret_cast<HWND>(handle), WM_CHAR, 'a', 0);
+		}
+#else
+		XEvent event = {};
+		event.xkey.type = isPressed ? KeyPress : KeyRelease;
+		event.xkey.display = g_SendDisplay;
+		event.xkey.window = static_cast<::Window>(handle);
+		event.xkey.keycode = XKeysymToKeycode(g_SendDisplay, XK_a);
+		event.xkey.same_screen = True;
+		XSendEvent(g_SendDisplay, event.xkey.window, False, 0, &event);
+		XFlush(g_SendDisplay);
+#endif
+	}
+
+	// A native window whose mouse move callback counts the events sent to it through the OS
+	static void CreateNativeEventWindow()
+	{
+		g_Window = Window::Create(MakeDescription());
+		g_Window->SetWindowMouseMoveCallback([](int x, int y) { g_ReceivedEvents++; });
+		OpenSendDisplay();
+	}
+
+	static void DestroyNativeEventWindow()
+	{
+		CloseSendDisplay();
+		DestroyWindow();
+	}
+
+	// Sends one motion event through the OS and pumps until its callback has run, so each operation is the full
+	// native path: display server or message queue, PollEvents, key and event translation, dispatch.
+	static uint64_t BenchmarkNativeEventLatency(uint64_t operations)
+	{
+		g_ReceivedEvents = 0;
+
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			SendNativeMouseMove(static_cast<int>(i % 256), 0);
+
+			const uint64_t deadline = Window::GetTime() + 1000000000ull;
+			while (g_ReceivedEvents <= i)
+			{
+				g_Window->PollEvents();
+				if (Window::GetTime() > deadline)
+				{
+					throw std::runtime_error("A native event did not arrive within a second");
+				}
+			}
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	// Each operation creates a window and destroys it from its own key callback while PollAllEvents is pumping.
+	// On X11 the window is the last one on the shared connection, so the pump has to keep the display open until it returns.
+	// The key is sent through the OS with native, and posted to the headless queue otherwise.
+	static uint64_t BenchmarkDestroyInCallback(uint64_t operations, bool native)
+	{
+		WindowDescription description = MakeDescription();
+		description.Headless = !native;
+
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			g_Window = Window::Create(description);
+
+			bool isDestroyed = false;
+			g_Window->SetWindowKeyCallback([&isDestroyed](KeyCode key, bool isPressed)
+				{
+					if (!isDestroyed)
+					{
+						g_Window->Destroy();
+						isDestroyed = true;
+					}
+				});
+
+			if (native)
+			{
+				SendNativeKey(true);
+			}
+			else
+			{
+				g_Window->PostEvent(Event::MakeKey(KeyCode::A, true));
+			}
+
+			const uint64_t deadline = Window::GetTime() + 1000000000ull;
+			while (!isDestroyed)
+			{
+				Window::PollAllEvents();
+				if (Window::GetTime() > deadline)
+				{
+					throw std::runtime_error("The key event that destroys the window did not arrive within a second");
+				}
+			}
+
+			g_Window = nullptr;
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	static std::atomic<uint64_t> g_PostTime{ 0 };
+	static uint64_t g_WakeLatency;
+
+	// A window whose key callback measures how long ago the event was posted
+	static std::function<void()> CreateWakeLatencyWindow(bool eventThread)
+	{
+		return [eventThread]()
+			{
+				WindowDescription description = MakeDescription();
+				description.EventThread = eventThread;
+
+				g_Window = Window::Create(description);
+				g_Window->SetWindowKeyCallback([](KeyCode key, bool isPressed)
+					{
+						g_WakeLatency += Window::GetTime() - g_PostTime;
+						g_ReceivedEvents++;
+					});
+			};
+	}
+
+	// Posts one event at a time to a thread sleeping in WaitEvents and reports the mean time until its callback runs.
+	// With an event thread the event takes an extra hop through the forwarding queue.
+	static uint64_t BenchmarkWakeLatency(uint64_t operations)
+	{
+		g_ReceivedEvents = 0;
+		g_WakeLatency = 0;
+		std::atomic<uint64_t> acknowledged{ 0 };
+
+		std::thread poster([operations, &acknowledged]()
+			{
+				for (uint64_t i = 0; i < operations; i++)
+				{
+					// Give the main thread time to fall asleep, so a real wakeup is measured
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+					g_PostTime = Window::GetTime();
+					g_Window->PostEvent(Event::MakeKey(KeyCode::A, true));
+
+					while (acknowledged.load() <= i)
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+
+		while (g_ReceivedEvents < operations)
+		{
+			g_Window->WaitEvents();
+			acknowledged = g_ReceivedEvents;
+		}
+		poster.join();
+
+		return g_WakeLatency;
+	}
+
+	// Reports the CPU time, not wall time, the process spends per 10 ms WaitEventsTimeout on an idle window.
+	// A wait that sleeps costs a few microseconds; one that polls costs close to the full 10 ms.
+	static uint64_t BenchmarkWaitEventsIdle(uint64_t operations)
+	{
+		const std::clock_t start = std::clock();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			g_Window->WaitEventsTimeout(0.01);
+		}
+
+		return static_cast<uint64_t>(static_cast<double>(std::clock() - start) * 1e9 / CLOCKS_PER_SEC);
+	}
+
+	static uint64_t BenchmarkDrawQuad(uint64_t operations, bool batched)
+	{
+		const uint64_t start = Window::GetTime();
+
+		Render::Clear();
+		if (batched)
+		{
+			Render::BeginBatch();
+		}
+
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			const float t = static_cast<float>(i % 1024) / 1024.0f;
+			Render::DrawQuad(t * 2.0f - 1.0f, 1.0f - t * 2.0f, 0.01f, { t, 0.5f, 1.0f - t, 1.0f });
+		}
+
+		if (batched)
+		{
+			Render::Flush();
+		}
+
+		// Include the time the driver takes to execute the draw, not just to record it
+		glFinish();
+		return Window::GetTime() - start;
+	}
+
+	// The event window with a context. native creates a platform window, fed through the OS, even without --native.
+	static std::function<void()> CreateSteadyStateWindow(bool native)
+	{
+		return [native]()
+			{
+				if (native)
+				{
+					WindowDescription description = MakeDescription();
+					description.Headless = false;
+
+					g_Window = Window::Create(description);
+					g_Window->SetWindowKeyCallback([](KeyCode key, bool isPressed) { g_ReceivedEvents++; });
+					g_Window->SetWindowMouseMoveCallback([](int x, int y) { g_ReceivedEvents++; });
+					g_Window->SetWindowCharacterCallback([](char character) { g_ReceivedEvents++; });
+					OpenSendDisplay();
+				}
+				else
+				{
+					CreateEventWindow();
+				}
+
+				g_Window->CreateContext(3, 3);
+				g_Window->SetSwapInterval(0);
+				Render::SetViewportSize(g_Window->GetWidth(), g_Window->GetHeight());
+			};
+	}
+
+	static void DestroySteadyStateWindow()
+	{
+		CloseSendDisplay();
+		DestroyWindow();
+	}
+
+	// One application frame: poll and dispatch a frame's worth of input, draw a batch of quads and present.
+	// Fails if any frame after the first allocates, so a regression shows up as a failed benchmark.
+	// With native, the input is sent through the OS beforehand, so PollEvents runs the X11 or Win32 pump;
+	// sending happens outside the counted region, only receiving is checked.
+	static uint64_t BenchmarkSteadyStateFrame(uint64_t operations, bool native)
+	{
+		const size_t eventsPerFrame = 64;
+		g_ReceivedEvents = 0;
+
+		uint64_t allocations = 0;
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			if (native)
+			{
+				for (int event = 0; event < 8; event++)
+				{
+					SendNativeMouseMove(static_cast<int>((i + event) % 256), event);
+				}
+				SendNativeKey(true);
+				SendNativeKey(false);
+			}
+
+			// The first frame of each run may still grow buffers
+			if (i > 0)
+			{
+				BeginCountingAllocations();
+			}
+
+			g_Window->PollEvents();
+			if (!native)
+			{
+				g_Window->InjectEvents(&g_Events[(i * eventsPerFrame) % g_Events.size()], eventsPerFrame);
+			}
+
+			Render::Clear();
+			Render::BeginBatch();
+			for (int quad = 0; quad < 64; quad++)
+			{
+				const float t = static_cast<float>(quad) / 64.0f;
+				Render::DrawQuad(t * 2.0f - 1.0f, 1.0f - t * 2.0f, 0.05f, { t, 0.5f, 1.0f - t, 1.0f });
+			}
+			Render::Flush();
+
+			g_Window->SwapBuffers();
+
+			allocations += EndCountingAllocations();
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		if (allocations != 0)
+		{
+			throw std::runtime_error(std::to_string(allocations) + " allocations in " + std::to_string(operations - 1) + " steady-state frames");
+		}
+
+		if (native && g_ReceivedEvents == 0)
+		{
+			throw std::runtime_error("No native events arrived, so the native pump was not exercised");
+		}
+
+		return elapsed;
+	}
+
+	static WindowPtr g_SharedWindow;
+	static SharedContextPtr g_WorkerContext;
+
+	// A window with a worker context, plus a second window whose context shares the first one's objects
+	static void CreateSharingWindows()
+	{
+		CreateWindowWithContext(false)();
+
+		g_SharedWindow = Window::Create(MakeDescription());
+		g_SharedWindow->CreateContext(3, 3, false, g_Window);
+
+		g_WorkerContext = g_Window->CreateWorkerContext();
+		if (!g_WorkerContext)
+		{
+			throw std::runtime_error("Failed to create a worker context");
+		}
+	}
+
+	static void DestroySharingWindows()
+	{
+		g_WorkerContext = nullptr;
+		if (g_SharedWindow)
+		{
+			g_SharedWindow->Destroy();
+			g_SharedWindow = nullptr;
+		}
+		DestroyWindow();
+	}
+
+	// Reads a texture back in the current context and checks it holds the colour it was filled with
+	static void CheckTexture(GLuint texture, uint32_t colour, int size, std::vector<uint32_t>& pixels, const char* context)
+	{
+		if (!glIsTexture(texture))
+		{
+			throw std::runtime_error(std::string("A texture uploaded by the worker is not visible in ") + context);
+		}
+
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		for (int i = 0; i < size * size; i++)
+		{
+			if (pixels[i] != colour)
+			{
+				throw std::runtime_error(std::string("A texture uploaded by the worker has the wrong contents in ") + context);
+			}
+		}
+	}
+
+	// Uploads textures of distinct colours on a worker thread, then reads every one back in the window's context
+	// and in the context of the window sharing with it. Fails if an object is missing or its contents differ.
+	static uint64_t BenchmarkWorkerUpload(uint64_t operations)
+	{
+		const int size = 256;
+		std::vector<GLuint> textures(operations);
+		std::vector<uint32_t> pixels(size * size);
+
+		bool isCurrent = false;
+
+		const uint64_t start = Window::GetTime();
+		std::thread worker([&textures, &pixels, &isCurrent]()
+			{
+				isCurrent = g_WorkerContext->MakeCurrent();
+				if (!isCurrent)
+					return;
+
+				glGenTextures(static_cast<GLsizei>(textures.size()), textures.data());
+				for (size_t i = 0; i < textures.size(); i++)
+				{
+					std::fill(pixels.begin(), pixels.end(), 0xFF000000u | static_cast<uint32_t>(i * 0x010305u));
+					glBindTexture(GL_TEXTURE_2D, textures[i]);
+					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+				}
+
+				// Uploads must be complete before another context uses them
+				glFinish();
+				g_WorkerContext->ReleaseCurrent();
+			});
+		worker.join();
+
+		if (!isCurrent)
+		{
+			throw std::runtime_error("Failed to make the worker context current");
+		}
+
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			const uint32_t colour = 0xFF000000u | static_cast<uint32_t>(i * 0x010305u);
+
+			g_Window->MakeContextCurrent();
+			CheckTexture(textures[i], colour, size, pixels, "the window's context");
+
+			g_SharedWindow->MakeContextCurrent();
+			CheckTexture(textures[i], colour, size, pixels, "the shared window's context");
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		g_Window->MakeContextCurrent();
+		glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+		return elapsed;
+	}
+
+	static std::vector<uint8_t> g_Pixels;
+
+	// A window of the given size with a capture callback that touches every delivered frame
+	static std::function<void()> CreateCaptureWindow(int width, int height)
+	{
+		return [width, height]()
+			{
+				WindowDescription description = MakeDescription();
+				description.Width = width;
+				description.Height = height;
+
+				g_Window = Window::Create(description);
+				g_Window->CreateContext(3, 3);
+				g_Window->SetSwapInterval(0);
+				g_Window->SetCaptureCallback([](const CapturedFrame& frame) { g_Sink = g_Sink + frame.Pixels[frame.Width * 4 + 1]; });
+				g_Pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+			};
+	}
+
+	// Renders, captures and presents one frame per operation. Every frame is delivered before the run ends.
+	// async goes through RequestCapture's ring of pixel buffers, otherwise each frame is read synchronously.
+	static uint64_t BenchmarkCapture(uint64_t operations, bool async)
+	{
+		const int width = g_Window->GetWidth();
+		const int height = g_Window->GetHeight();
+
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			glClearColor(static_cast<float>(i % 2), 0.5f, 0.5f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			if (async)
+			{
+				g_Window->RequestCapture();
+			}
+			else
+			{
+				// The baseline: a synchronous read that waits for the frame to finish rendering
+				glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, g_Pixels.data());
+				g_Sink = g_Sink + g_Pixels[1];
+			}
+
+			g_Window->SwapBuffers();
+		}
+		g_Window->FlushCaptures();
+
+		return Window::GetTime() - start;
+	}
+
+	// Converts a captured 1080p frame to Y4M's planar YUV, as the capture sink's writer thread does
+	static uint64_t BenchmarkConvertYUV(uint64_t operations)
+	{
+		const int width = 1920;
+		const int height = 1080;
+
+		std::vector<uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+		for (size_t i = 0; i < rgba.size(); i++)
+		{
+			rgba[i] = static_cast<uint8_t>(i * 31);
+		}
+
+		std::vector<uint8_t> yuv(static_cast<size_t>(width) * height * 3 / 2);
+		uint8_t* y = yuv.data();
+		uint8_t* u = y + width * height;
+		uint8_t* v = u + width * height / 4;
+
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			Internal::ConvertRGBAToI420(rgba.data(), width * 4, width, height, y, u, v);
+		}
+		const uint64_t elapsed = Window::GetTime() - start;
+
+		g_Sink = yuv[static_cast<size_t>(g_Sink % yuv.size())];
+		return elapsed;
+	}
+
+	static uint64_t BenchmarkSwapBuffers(uint64_t operations)
+	{
+		const uint64_t start = Window::GetTime();
+		for (uint64_t i = 0; i < operations; i++)
+		{
+			g_Window->SwapBuffers();
+		}
+
+		return Window::GetTime() - start;
+	}
+
+	std::vector<Benchmark> CreateBenchmarks()
+	{
+		std::vector<Benchmark> benchmarks;
+
+		benchmarks.push_back({ "Window/CreateDestroy", 20, nullptr, [] { return BenchmarkCreateDestroy(20); }, nullptr });
+		benchmarks.push_back({ "Window/CreateContext", 10, nullptr, [] { return BenchmarkCreateContext(10, false); }, nullptr });
+		benchmarks.push_back({ "Window/CreateContextLegacy", 10, nullptr, [] { return BenchmarkCreateContext(10, true); }, nullptr });
+
+		benchmarks.push_back({ "Context/WorkerUpload", 64, CreateSharingWindows, [] { return BenchmarkWorkerUpload(64); }, DestroySharingWindows });
+
+		benchmarks.push_back({ "GL/LoadFunctions", 1000, CreateWindowWithContext(false), [] { return BenchmarkLoadGLFunctions(1000); }, DestroyWindow });
+		benchmarks.push_back({ "GL/LoadFunctionsCached", 1000, CreateWindowWithContext(false), [] { return BenchmarkAcquireGLFunctions(1000); }, DestroyWindow });
+
+		benchmarks.push_back({ "Events/InjectEvent", 1 << 20, CreateEventWindow, [] { return BenchmarkInjectEvent(1 << 20); }, DestroyWindow });
+		benchmarks.push_back({ "Events/InjectEventsBatched", 1 << 20, CreateEventWindow, [] { return BenchmarkInjectEventsBatched(1 << 20); }, DestroyWindow });
+		benchmarks.push_back({ "Events/InjectEventsCoalesced", 1 << 20, CreateCoalescingEventWindow, [] { return BenchmarkInjectEventsBatched(1 << 20); }, DestroyWindow });
+		benchmarks.push_back({ "Events/EventThreadWakeup", 20000, CreateEventThreadWindow, [] { return BenchmarkEventThreadWakeup(20000); }, DestroyWindow });
+		benchmarks.push_back({ "Events/DestroyInCallback", 100, nullptr, [] { return BenchmarkDestroyInCallback(100, false); }, DestroyWindow });
+		benchmarks.push_back({ "Events/WakeLatency", 1000, CreateWakeLatencyWindow(false), [] { return BenchmarkWakeLatency(1000); }, DestroyWindow });
+		benchmarks.push_back({ "Events/WakeLatencyEventThread", 1000, CreateWakeLatencyWindow(true), [] { return BenchmarkWakeLatency(1000); }, DestroyWindow });
+		benchmarks.push_back({ "Events/WaitEventsIdleCPU", 20, CreateWakeLatencyWindow(true), [] { return BenchmarkWaitEventsIdle(20); }, DestroyWindow });
+
+		benchmarks.push_back({ "Input/KeyTranslation", 1 << 22, nullptr, [] { return BenchmarkKeyTranslation(1 << 22, false); }, nullptr });
+		benchmarks.push_back({ "Input/KeyTranslationMap", 1 << 14, nullptr, [] { return BenchmarkKeyTranslation(1 << 14, true); }, nullptr });
+
+		// Quad-count sweep: if batching scales, the cost per quad stays flat as the batch grows while the
+		// immediate path pays per quad. Immediate mode stops at 100K, a million calls would take minutes per run.
+		struct QuadCount { uint64_t Quads; const char* Suffix; };
+		for (const QuadCount& count : { QuadCount{ 1000, "1K" }, QuadCount{ 10000, "10K" }, QuadCount{ 100000, "100K" }, QuadCount{ 1000000, "1M" } })
+		{
+			const uint64_t quads = count.Quads;
+			benchmarks.push_back({ std::string("Render/DrawQuadBatched") + count.Suffix, quads, CreateWindowWithContext(false), [quads] { return BenchmarkDrawQuad(quads, true); }, DestroyWindow });
+			if (quads <= 100000)
+			{
+				benchmarks.push_back({ std::string("Render/DrawQuadImmediate") + count.Suffix, quads, CreateWindowWithContext(true), [quads] { return BenchmarkDrawQuad(quads, false); }, DestroyWindow });
+			}
+		}
+		benchmarks.push_back({ "Render/SwapBuffers", 500, CreateWindowWithContext(false), [] { return BenchmarkSwapBuffers(500); }, DestroyWindow });
+
+		benchmarks.push_back({ "Frame/SteadyStateAllocations", 500, CreateSteadyStateWindow(false), [] { return BenchmarkSteadyStateFrame(500, false); }, DestroySteadyStateWindow });
+		if (g_Options.Native || HasDisplay())
+		{
+			benchmarks.push_back({ "Events/NativeDestroyInCallback", 100, OpenSendDisplay, [] { return BenchmarkDestroyInCallback(100, true); }, DestroyNativeEventWindow });
+			benchmarks.push_back({ "Frame/NativeSteadyAllocations", 500, CreateSteadyStateWindow(true), [] { return BenchmarkSteadyStateFrame(500, true); }, DestroySteadyStateWindow });
+		}
+
+		benchmarks.push_back({ "Capture/ReadPixels1080p", 60, CreateCaptureWindow(1920, 1080), [] { return BenchmarkCapture(60, false); }, DestroyWindow });
+		benchmarks.push_back({ "Capture/Async1080p", 60, CreateCaptureWindow(1920, 1080), [] { return BenchmarkCapture(60, true); }, DestroyWindow });
+		benchmarks.push_back({ "Capture/ReadPixels4K", 30, CreateCaptureWindow(3840, 2160), [] { return BenchmarkCapture(30, false); }, DestroyWindow });
+		benchmarks.push_back({ "Capture/Async4K", 30, CreateCaptureWindow(3840, 2160), [] { return BenchmarkCapture(30, true); }, DestroyWindow });
+		benchmarks.push_back({ "Capture/ConvertYUV1080p", 100, nullptr, [] { return BenchmarkConvertYUV(100); }, nullptr });
+
+		// Headless windows have no OS queue to go through
+		if (g_Options.Native)
+		{
+			benchmarks.push_back({ "Events/NativeEventLatency", 2000, CreateNativeEventWindow, [] { return BenchmarkNativeEventLatency(2000); }, DestroyNativeEventWindow });
+		}
+
+#ifdef __linux__
+		// Native X11 windows through EGL instead of GLX, to compare against Window/CreateContext and Render/SwapBuffers.
+		// Headless windows already use EGL, so these only run with --native.
+		if (g_Options.Native)
+		{
+			benchmarks.push_back({ "Window/CreateContextEGL", 10, nullptr, [] { return BenchmarkCreateContext(10, false, true); }, nullptr });
+			benchmarks.push_back({ "Render/DrawQuadBatchedEGL", 100000, CreateWindowWithContext(false, true), [] { return BenchmarkDrawQuad(100000, true); }, DestroyWindow });
+			benchmarks.push_back({ "Render/SwapBuffersEGL", 500, CreateWindowWithContext(false, true), [] { return BenchmarkSwapBuffers(500); }, DestroyWindow });
+		}
+#endif
+
+		return benchmarks;
+	}
+}//Namespace SwindowBenchmarks
+
+int main(int argc, char** argv)
+{
+	using namespace SwindowBenchmarks;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+
+		if (std::strcmp(argv[i], "--native") == 0)
+		{
+			g_Options.Native = true;
+		}
+		else if (std::strcmp(argv[i], "--runs") == 0 && hasValue)
+		{
+			const int runs = std::atoi(argv[++i]);
+			g_Options.Runs = runs > 0 ? static_cast<size_t>(runs) : 1;
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+		{
+			g_Options.Filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+		{
+			g_Options.OutputPath = argv[++i];
+		}
+		else
+		{
+			std::printf("Usage: %s [--native] [--runs N] [--filter text] [--output path]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<Result> results;
+	bool failed = false;
+
+	for (const Benchmark& benchmark : CreateBenchmarks())
+	{
+		if (!g_Options.Filter.empty() && benchmark.Name.find(g_Options.Filter) == std::string::npos)
+			continue;
+
+		results.push_back(RunBenchmark(benchmark, g_Options.Runs));
+		const Result& result = results.back();
+
+		if (result.Error.empty())
+		{
+			std::printf("%-32s %14.1f ns/op (min %.1f, max %.1f)\n", result.Name.c_str(), result.Median, result.Min, result.Max);
+		}
+		else
+		{
+			std::printf("%-32s failed: %s\n", result.Name.c_str(), result.Error.c_str());
+			failed = true;
+		}
+	}
+
+	if (!WriteResults(results, g_Options.OutputPath))
+	{
+		std::printf("Failed to write %s\n", g_Options.OutputPath.c_str());
+		return 1;
+	}
+
+	return failed ? 1 : 0;
+}
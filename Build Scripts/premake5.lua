@@ -9,6 +9,7 @@ workspace "Swindow"
     outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
     include "../Examples"
+    include "../Benchmarks"
     include "../Third-Party/imgui"
 
     
\ No newline at end of file
@@ -28,6 +28,16 @@ project "Examples"
         "SW_PLATFORM_WINDOWS" 
     }
 
+    filter "system:linux"
+    links
+    {
+        "X11",
+        "GL",
+        "EGL",
+        "dl",
+        "pthread",
+    }
+
     filter "configurations:Debug"
         defines { "SWINDOW_DEBUG" }
         symbols "On"
@@ -22,6 +22,8 @@ namespace ImGuiExample
 	void Run()
 	{
 		using namespace Swindow;
+		using Swindow::Window;
+		using Swindow::KeyCode;
 
 		// Configure window properties
 		WindowDescription desc;
@@ -0,0 +1,153 @@
+﻿/*
+ * Example usage of Swindow worker contexts for uploading resources off the render thread.
+ * A worker thread regenerates a texture twice a second while the main thread keeps drawing it.
+ */
+
+#include "SharedContextExample.h"
+
+#include "../../Swindow.h"
+
+namespace SharedContextExample
+{
+	using namespace Swindow;
+	using Swindow::Window;
+	using Swindow::KeyCode;
+
+	static constexpr int TextureSize = 256;
+
+	static WindowPtr g_Window;
+
+	// Two textures so the worker fills the one that is not on screen
+	static GLuint g_Textures[2];
+	static std::atomic<int> g_ReadyTexture{ -1 };
+	static std::atomic<bool> g_Running{ true };
+
+	// Fills a checkerboard whose colour changes with every generation
+	static void GeneratePixels(std::vector<uint32_t>& pixels, uint32_t generation)
+	{
+		const uint32_t red = (generation * 53) & 0xFF;
+		const uint32_t green = (generation * 101) & 0xFF;
+		const uint32_t blue = (generation * 197) & 0xFF;
+		const uint32_t color = 0xFF000000 | (blue << 16) | (green << 8) | red;
+
+		for (int y = 0; y < TextureSize; y++)
+		{
+			for (int x = 0; x < TextureSize; x++)
+			{
+				const bool light = ((x / 32) + (y / 32)) % 2 == 0;
+				pixels[y * TextureSize + x] = light ? color : 0xFF202020;
+			}
+		}
+	}
+
+	// Runs on the worker thread with the shared context current
+	static void UploadLoop(SharedContext& context)
+	{
+		context.MakeCurrent();
+
+		std::vector<uint32_t> pixels(TextureSize * TextureSize);
+		uint32_t generation = 0;
+
+		while (g_Running)
+		{
+			const int target = (g_ReadyTexture + 1) % 2;
+			GeneratePixels(pixels, generation++);
+
+			glBindTexture(GL_TEXTURE_2D, g_Textures[target]);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TextureSize, TextureSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+			// The upload has to complete before the render thread may sample the texture
+			glFinish();
+			g_ReadyTexture = target;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(500));
+		}
+
+		context.ReleaseCurrent();
+	}
+
+	static void KeyCallback(KeyCode key, bool isPressed)
+	{
+		if (isPressed && key == KeyCode::Escape)
+		{
+			g_Window->SetIsRunning(false);
+		}
+	}
+
+	// Draws a texture over most of the window using the fixed function pipeline
+	static void DrawTexture(GLuint texture)
+	{
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+		glBegin(GL_QUADS);
+		glTexCoord2f(0.0f, 0.0f); glVertex2f(-0.8f, -0.8f);
+		glTexCoord2f(1.0f, 0.0f); glVertex2f(0.8f, -0.8f);
+		glTexCoord2f(1.0f, 1.0f); glVertex2f(0.8f, 0.8f);
+		glTexCoord2f(0.0f, 1.0f); glVertex2f(-0.8f, 0.8f);
+		glEnd();
+
+		glDisable(GL_TEXTURE_2D);
+	}
+
+	// Initializes and runs the application
+	void Run()
+	{
+		WindowDescription desc;
+		desc.Title = "Swindow Shared Contexts";
+		desc.Width = 720;
+		desc.Height = 500;
+
+		g_Window = Window::Create(desc);
+		g_Window->SetWindowKeyCallback(KeyCallback);
+		g_Window->SetWindowResizeCallback([](int width, int height) { Render::SetViewportSize(width, height); });
+
+		g_Window->CreateContext(1, 1, true);
+		Render::SetViewportSize(desc.Width, desc.Height);
+
+		// Storage is allocated up front; the worker only replaces the contents
+		glGenTextures(2, g_Textures);
+		for (GLuint texture : g_Textures)
+		{
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TextureSize, TextureSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+
+		// Make sure the textures exist before the worker context touches them
+		glFinish();
+
+		SharedContextPtr workerContext = g_Window->CreateWorkerContext();
+		if (!workerContext)
+		{
+			g_Window->Destroy();
+			return;
+		}
+
+		std::thread worker(UploadLoop, std::ref(*workerContext));
+
+		while (g_Window->GetIsRunning())
+		{
+			g_Window->PollEvents();
+
+			Render::Clear();
+
+			const int ready = g_ReadyTexture;
+			if (ready >= 0)
+			{
+				DrawTexture(g_Textures[ready]);
+			}
+
+			g_Window->SwapBuffers();
+		}
+
+		g_Running = false;
+		worker.join();
+		workerContext = nullptr;
+
+		glDeleteTextures(2, g_Textures);
+		g_Window->Destroy();
+	}
+}//Namespace SharedContextExample
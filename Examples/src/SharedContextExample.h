@@ -0,0 +1,6 @@
+﻿#pragma once
+
+namespace SharedContextExample
+{
+	void Run();
+}//Namespace SharedContextExample
@@ -10,6 +10,8 @@
 namespace SwindowExample
 {
 	using namespace Swindow;
+	using Swindow::Window;
+	using Swindow::KeyCode;
 
 	// Stores the mouse position in normalized world coordinates (-1 to 1)
 	struct MousePosition
@@ -67,8 +69,8 @@ namespace SwindowExample
 	// Converts mouse screen coordinates to normalized world coordinates (-1 to 1)
 	static void MousePositionCallback(int mouseX, int mouseY)
 	{
-		float screenWidth = static_cast<float>(g_Window->GetWindowDescription().Width);
-		float screenHeight = static_cast<float>(g_Window->GetWindowDescription().Height);
+		float screenWidth = static_cast<float>(g_Window->GetWidth());
+		float screenHeight = static_cast<float>(g_Window->GetHeight());
 
 		// Convert pixel position to OpenGL world coordinates (-1 to 1)
 		g_MousePosition.x = (static_cast<float>(mouseX) / screenWidth) * 2.0f - 1.0f;
@@ -128,6 +130,9 @@ namespace SwindowExample
 
 			Render::Clear();        // Clear the screen
 
+			// Collect every quad this frame and draw them with a single draw call
+			Render::BeginBatch();
+
 			// Draw background quad at the center
 			Render::DrawQuad(0, 0, 1.0f, { 0.35f, 0.55f, 0.75f, 1.0f });
 
@@ -137,6 +142,8 @@ namespace SwindowExample
 				Render::DrawQuad(obj.x, obj.y, 0.05f, { 1.0f, 0.0f, 0.0f, 1.0f });
 			}
 
+			Render::Flush();
+
 			g_Window->SwapBuffers(); // Display rendered frame
 		}
 
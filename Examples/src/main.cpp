@@ -1,9 +1,11 @@
 #include "ImGuiExample.h"
+#include "SharedContextExample.h"
 #include "SimpleExample.h"
 
 // Application entry point
 int main()
 {
 	//SwindowExample::Run();
+	//SharedContextExample::Run();
 	ImGuiExample::Run();
 }
\ No newline at end of file
@@ -5,12 +5,39 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <typeindex>
 #include <unordered_map>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SW_PRINTF_FORMAT(formatIndex, firstArgument) __attribute__((format(printf, formatIndex, firstArgument)))
+#else
+#define SW_PRINTF_FORMAT(formatIndex, firstArgument)
+#endif
+
+//SSE2 is part of every x86-64 target, so the vectorised paths need no runtime detection
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SW_SSE2
+#include <emmintrin.h>
+#endif
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -19,11 +46,28 @@
 #pragma comment (lib, "opengl32.lib")
 #endif
 
-#ifdef __LINUX__
+#ifdef __linux__
+//Xlib declares global `Window` and `KeyCode` types. They are left untouched so Swindow can be combined with other code
+//using Xlib; inside the header the native handle is always spelled ::Window. After `using namespace Swindow;` at global
+//scope the names are ambiguous on Linux, so bring them in with `using Swindow::Window;` and `using Swindow::KeyCode;`.
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <X11/Xos.h>
-#endif	
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+ //Include for OpenGL; including context creation.
+#include <GL/glx.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+ //Include for EGL; used by the headless backend.
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 namespace Swindow
 {
@@ -38,6 +82,8 @@ namespace Swindow
 	{
 		class NativeWindow;
 		class RenderContext;
+		class Logger;
+		struct GLFunctions;
 	}//Namespace Internal
 
 	//Types
@@ -46,6 +92,10 @@ namespace Swindow
 
 	using Render = Internal::RenderContext;
 
+	using GLFunctions = Internal::GLFunctions;
+
+	using Logger = Internal::Logger;
+
 	namespace Internal
 	{
 		using NativeWindowPtr = std::shared_ptr<Internal::NativeWindow>;
@@ -130,865 +180,5838 @@ namespace Swindow
 		std::string Title;
 		int Width;
 		int Height;
+
+		//Creates an offscreen window that needs no display server. Rendering goes to a pbuffer instead of the screen.
+		bool Headless = false;
+
+		//Linux only: creates the OpenGL context of an X11 window through EGL instead of GLX.
+		//Headless windows always use EGL.
+		bool UseEGL = false;
+
+		//Copies every event into a queue that can be drained with Window::NextEvent, in addition to the callbacks.
+		bool QueueEvents = false;
+
+		//Pumps the native event queue on a dedicated thread owned by Swindow. Events are forwarded through a
+		//lock-free queue and callbacks still run on the thread calling PollEvents, which also keeps the GL context.
+		bool EventThread = false;
 	};
 
-	struct WindowCallbacks
+	/**
+	 * @brief Which swap intervals the window's OpenGL context can honour.
+	 */
+	struct SwapIntervalSupport
 	{
-		//Basic Window Callbacks
-		WindowResizeCallback WindowResizeCallback;
-		WindowCloseCallback WindowCloseCallback;
+		bool Interval = false; //0 disables vsync, 1 or more waits for that many vertical blanks
+		bool Adaptive = false; //Negative intervals: swaps that miss the vertical blank happen immediately instead of waiting
+	};
 
-		//Input Callbacks
-		WindowKeyCallback WindowKeyCallback;
-		WindowMouseCallback WindowMouseCallback;
-		WindowMouseMoveCallback WindowMouseMoveCallback;
-		WindowCharacterCallback WindowCharacterCallback;
+	//Events
+
+	enum class EventType : uint8_t
+	{
+		Unknown = 0,
+		Key,
+		Character,
+		MouseButton,
+		MouseMove,
+		MouseScroll,
+		Resize,
+		Close,
 	};
 
-	class Window
+	/**
+	 * @brief A single window event.
+	 *
+	 * A compact tagged union: check Type, then read the matching member.
+	 * Events are plain data, so they can be copied into a queue without allocating.
+	 */
+	struct Event
+	{
+		struct KeyEvent { KeyCode Key; bool IsPressed; };
+		struct CharacterEvent { char Character; };
+		struct MouseButtonEvent { MouseButton Button; bool IsPressed; };
+		struct MouseMoveEvent { int X, Y; uint64_t Time; }; //Time: when the OS sampled the position on the Window::GetTime clock, 0 if unknown
+		struct MouseScrollEvent { float X, Y; };
+		struct ResizeEvent { int Width, Height; };
+
+		EventType Type = EventType::Unknown;
+
+		union
+		{
+			KeyEvent Key;
+			CharacterEvent Character;
+			MouseButtonEvent Button;
+			MouseMoveEvent Motion;
+			MouseScrollEvent Scroll;
+			ResizeEvent Size;
+		};
+
+		Event() : Size{ 0, 0 } {}
+
+		//Helpers for building events, e.g. for Window::InjectEvent
+		static Event MakeKey(KeyCode key, bool isPressed) { Event event; event.Type = EventType::Key; event.Key = { key, isPressed }; return event; }
+		static Event MakeCharacter(char character) { Event event; event.Type = EventType::Character; event.Character = { character }; return event; }
+		static Event MakeMouseButton(MouseButton button, bool isPressed) { Event event; event.Type = EventType::MouseButton; event.Button = { button, isPressed }; return event; }
+		static Event MakeMouseMove(int x, int y, uint64_t time = 0) { Event event; event.Type = EventType::MouseMove; event.Motion = { x, y, time }; return event; }
+		static Event MakeMouseScroll(float x, float y) { Event event; event.Type = EventType::MouseScroll; event.Scroll = { x, y }; return event; }
+		static Event MakeResize(int width, int height) { Event event; event.Type = EventType::Resize; event.Size = { width, height }; return event; }
+		static Event MakeClose() { Event event; event.Type = EventType::Close; return event; }
+	};
+
+	/**
+	 * @brief One mouse position received from the OS, kept even when motion is coalesced.
+	 */
+	struct MouseMotionSample
+	{
+		int X, Y;
+		uint64_t Timestamp; //When the OS sampled the position, in nanoseconds on the Window::GetTime clock
+	};
+
+	/**
+	 * @brief How Window::StartReplay paces recorded events.
+	 */
+	enum class ReplayMode : uint8_t
+	{
+		RealTime = 0, //Events are dispatched when their recorded timestamp is reached
+		Fast, //Each PollEvents dispatches the events of the next recorded frame, without waiting
+	};
+
+	/**
+	 * @brief Severity of a log message.
+	 */
+	enum class LogLevel : uint8_t
+	{
+		Trace = 0,
+		Debug,
+		Info,
+		Warning,
+		Error,
+		Off,
+	};
+
+	/**
+	 * @brief Frame time statistics over a window's recent frames. Times are in nanoseconds.
+	 */
+	struct FrameStats
+	{
+		size_t FrameCount = 0; //Frames the statistics were computed from
+		uint64_t Min = 0;
+		uint64_t Max = 0;
+		double Mean = 0.0;
+		uint64_t P50 = 0;
+		uint64_t P95 = 0;
+		uint64_t P99 = 0;
+	};
+
+	/**
+	 * @brief A frame read back by Window::RequestCapture.
+	 *
+	 * Pixels are tightly packed RGBA8 with the bottom row first, as OpenGL reads them.
+	 * They are only valid during the capture callback, so copy them to keep them.
+	 */
+	struct CapturedFrame
+	{
+		const uint8_t* Pixels = nullptr;
+		int Width = 0;
+		int Height = 0;
+		uint64_t FrameIndex = 0; //SwapBuffers calls on the window before this frame was presented
+		uint64_t Timestamp = 0;  //Window::GetTime when the frame was read back
+	};
+
+	/**
+	 * @brief Callback type for frames captured with Window::RequestCapture.
+	 *
+	 * Called from SwapBuffers on the render thread, one or more frames after the capture was requested.
+	 *
+	 * @param frame The captured frame.
+	 */
+	using WindowCaptureCallback = std::function<void(const CapturedFrame& frame)>;
+
+	namespace Internal
 	{
-	public:
 		/**
-		 * @brief Default constructor. Should not be used directly.
+		 * @brief Fixed-capacity, lock-free single-producer/single-consumer ring buffer.
 		 *
-		 * Use Window::Create instead to properly initialize a window.
+		 * One thread may Push while another thread Pops. Capacity must be a power of two.
 		 */
-		Window() = default;
+		template<typename T, size_t Capacity>
+		class SPSCQueue
+		{
+			static_assert((Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two");
+
+		public:
+			//Returns false if the queue is full
+			bool Push(const T& item)
+			{
+				const size_t head = m_Head.load(std::memory_order_relaxed);
+				if (head - m_Tail.load(std::memory_order_acquire) == Capacity)
+					return false;
+
+				m_Items[head & (Capacity - 1)] = item;
+				m_Head.store(head + 1, std::memory_order_release);
+				return true;
+			}
+
+			//Returns false if the queue is empty
+			bool Pop(T& item)
+			{
+				const size_t tail = m_Tail.load(std::memory_order_relaxed);
+				if (tail == m_Head.load(std::memory_order_acquire))
+					return false;
+
+				item = m_Items[tail & (Capacity - 1)];
+				m_Tail.store(tail + 1, std::memory_order_release);
+				return true;
+			}
+
+			bool IsEmpty() const
+			{
+				return m_Tail.load(std::memory_order_acquire) == m_Head.load(std::memory_order_acquire);
+			}
 
-		~Window() = default;
+		private:
+			//Producer and consumer indices are kept on separate cache lines so the two threads do not contend
+			std::atomic<size_t> m_Head{ 0 };
+			char m_HeadPadding[64 - sizeof(std::atomic<size_t>)];
+			std::atomic<size_t> m_Tail{ 0 };
+			char m_TailPadding[64 - sizeof(std::atomic<size_t>)];
+			T m_Items[Capacity];
+		};
 
 		/**
-		 * @brief Creates the main application window.
-		 *
-		 * This function initializes and creates a new window with the specified settings.
+		 * @brief Per-frame keyboard and mouse state, built from the events a window dispatches.
 		 *
-		 * @param description The settings defining the properties of the window.
-		 * @return A shared pointer to the newly created window.
+		 * Two snapshots are kept: the one being filled by the current PollEvents and the one from the previous call.
 		 */
-		static WindowPtr Create(const WindowDescription& description);
+		class InputState
+		{
+		public:
+			struct Snapshot
+			{
+				//KeyCode is a uint8_t, so any value indexes these without a bounds check
+				std::bitset<256> Keys;
+				std::bitset<256> PressedKeys;
+				std::bitset<256> ReleasedKeys;
+
+				uint32_t Buttons = 0;
+				uint32_t PressedButtons = 0;
+				uint32_t ReleasedButtons = 0;
+
+				int MouseX = 0;
+				int MouseY = 0;
+				float WheelX = 0.0f;
+				float WheelY = 0.0f;
+			};
+
+			//Flips the snapshots. Called at the start of every PollEvents.
+			void BeginFrame();
+
+			void ProcessEvent(const Event& event);
+
+			const Snapshot& GetCurrent() const { return m_Current; }
+			const Snapshot& GetPrevious() const { return m_Previous; }
+
+			//The bit of a button in the Buttons masks. MouseButton is an int, so a value past the last button,
+			//e.g. from an injected event, gets no bit instead of an undefined shift.
+			static uint32_t ButtonMask(MouseButton button);
+
+		private:
+			Snapshot m_Current;
+			Snapshot m_Previous;
+		};
 
 		/**
-		 * @brief Destroys the window.
+		 * @brief Fixed-size ring of the most recent frame times.
 		 *
-		 * This function releases all resources associated with the window.
+		 * Storage is allocated by SetCapacity only, so recording a frame never allocates.
 		 */
-		void Destroy() const;
+		class FrameTimeHistory
+		{
+		public:
+			//Resizes the ring and discards every recorded frame
+			void SetCapacity(size_t capacity);
+			size_t GetCapacity() const { return m_Samples.size(); }
+
+			void Push(uint64_t frameTime);
+
+			FrameStats ComputeStats() const;
+
+		private:
+			std::vector<uint64_t> m_Samples;
+			mutable std::vector<uint64_t> m_Sorted; //Scratch space for the percentiles, same size as m_Samples
+			size_t m_Next = 0;
+			size_t m_Count = 0;
+		};
 
 		/**
-		 * @brief Checks if the window is still running.
+		 * @brief Layout of an event log: an EventLogHeader followed by an array of RecordedEvent.
 		 *
-		 * @return True if the window is running, false otherwise.
+		 * Records are fixed size and 8-byte aligned, so a mapped log is read in place without parsing.
+		 * A record with EventType::Unknown marks the start of a PollEvents frame.
 		 */
-		bool GetIsRunning() const;
+		struct EventLogHeader
+		{
+			char Magic[4]; //"SWEV"
+			uint32_t Version;
+			uint32_t RecordSize;
+			uint32_t Reserved;
+		};
+
+		struct RecordedEvent
+		{
+			uint64_t Timestamp; //Nanoseconds since recording started
+			Swindow::Event Data;
+		};
+
+		constexpr uint32_t EventLogVersion = 2;
 
 		/**
-		 * @brief Sets the running state of the window.
+		 * @brief Writes dispatched events to an event log.
 		 *
-		 * @param value True to keep the window running, false to stop it.
+		 * Record only copies the event into a lock-free queue. A writer thread drains the queue into large
+		 * sequential writes, so the dispatching thread never waits on the disk.
 		 */
-		void SetIsRunning(bool value);
+		class EventRecorder
+		{
+		public:
+			~EventRecorder() { Stop(); }
+
+			bool Start(const std::string& path);
+			void Stop();
+
+			void Record(const Event& event);
+
+			//Starts a new frame in the log. Consecutive frames without events share one marker.
+			void MarkFrame();
+
+		private:
+			void Push(const RecordedEvent& record);
+			void WriterLoop();
+
+		private:
+			static constexpr size_t QueueCapacity = 1 << 16;
+
+			std::FILE* m_File = nullptr;
+			std::thread m_WriterThread;
+			std::atomic<bool> m_IsRunning{ false };
+			std::unique_ptr<SPSCQueue<RecordedEvent, QueueCapacity>> m_Queue;
+			uint64_t m_StartTime = 0;
+			bool m_FrameHasEvents = true;
+		};
 
 		/**
-		 * @brief Creates an OpenGL rendering context for the window.
-		 *
-		 * This function initializes an OpenGL context with the specified version.
-		 * It supports both modern and legacy OpenGL versions.
-		 *
-		 * @param major The major OpenGL version (default is 4).
-		 * @param minor The minor OpenGL version (default is 6).
-		 * @param legacy Set to true to use legacy OpenGL (1.x or earlier) (default is false).
+		 * @brief Read-only memory mapping of an event log.
 		 */
-		void CreateContext(int major = 4, int minor = 6, bool legacy = false) const;
+		class EventLog
+		{
+		public:
+			~EventLog() { Close(); }
+
+			bool Open(const std::string& path);
+			void Close();
+
+			//Only the header is checked by Open, so every record is checked before it is dispatched: a corrupt or foreign
+			//log must not reach the input state with an event type, mouse button or bool outside its valid values
+			static bool IsValidEvent(const Event& event);
+
+			const RecordedEvent* GetRecords() const { return m_Records; }
+			size_t GetCount() const { return m_Count; }
+
+		private:
+			const RecordedEvent* m_Records = nullptr;
+			size_t m_Count = 0;
+
+			const void* m_Mapping = nullptr;
+			size_t m_MappingSize = 0;
+#ifdef _WIN32
+			HANDLE m_File = INVALID_HANDLE_VALUE;
+			HANDLE m_FileMapping = nullptr;
+#endif
+		};
 
 		/**
-		 * @brief Swaps the front and back buffers.
+		 * @brief Asynchronous framebuffer readback through a ring of pixel buffer objects.
 		 *
-		 * This function is typically called at the end of a render loop to present the next frame.
+		 * Each capture reads the back buffer into a free buffer and places a fence behind it. Later frames
+		 * only map buffers whose fence has already signalled, so the CPU never waits for the GPU. When every
+		 * buffer is still in flight the capture is dropped instead. Requires an OpenGL 3.2 context.
 		 */
-		void SwapBuffers() const;
+		class FrameCapture
+		{
+		public:
+			static constexpr size_t DefaultRingSize = 3;
+
+			void SetCallback(const WindowCaptureCallback& callback) { m_Callback = callback; }
+
+			//Takes effect once no capture is in flight
+			void SetRingSize(size_t size) { m_RingSize = size > 0 ? size : 1; }
 
+			void Request() { m_Requested = true; }
+
+			//Called before the buffers are swapped: delivers finished captures, then starts the requested one
+			void Update(int width, int height, uint64_t frameIndex);
+
+			//Blocks until every capture in flight has been delivered
+			void Flush();
+
+			//Releases the buffers. The window's context must be current.
+			void Shutdown();
+
+			size_t GetPendingCount() const { return m_Count; }
+			size_t GetDroppedCount() const { return m_Dropped; }
+
+		private:
+			struct Slot
+			{
+				GLuint Buffer = 0;
+				size_t Capacity = 0;
+				void* Fence = nullptr;
+				int Width = 0;
+				int Height = 0;
+				uint64_t FrameIndex = 0;
+			};
+
+			//Delivers the oldest captures in order. Stops at the first one still in flight unless wait is set.
+			void Deliver(bool wait);
+
+		private:
+			WindowCaptureCallback m_Callback;
+			std::vector<Slot> m_Slots;
+			size_t m_RingSize = DefaultRingSize;
+			size_t m_Head = 0;  //Oldest capture in flight
+			size_t m_Count = 0; //Captures in flight
+			size_t m_Dropped = 0;
+			bool m_Requested = false;
+		};
+	}//Namespace Internal
+
+	/**
+	 * @brief Pacing error statistics collected by a FramePacer. Times are in nanoseconds.
+	 */
+	struct FramePacerStats
+	{
+		uint64_t FrameCount = 0; //Frames passed through Wait while a target was set
+		uint64_t LateFrames = 0; //Frames that reached Wait after their deadline had already passed
+		double MeanError = 0.0; //Average time woken after the deadline, on-time frames only
+		uint64_t MaxError = 0; //Worst time woken after the deadline, on-time frames only
+		uint64_t SleepTime = 0; //Total time spent sleeping
+		uint64_t SpinTime = 0; //Total time spent spinning
+	};
+
+	/**
+	 * @brief Limits a loop to a target frame time without relying on vsync.
+	 *
+	 * Wait sleeps in short slices while the deadline is far away and spins on the monotonic clock for the
+	 * remainder. The spin window is calibrated from how long sleeps actually take, so it stays small on
+	 * platforms with precise timers and grows on platforms with coarse ones.
+	 */
+	class FramePacer
+	{
+	public:
 		/**
-		 * @brief Processes window events.
+		 * @brief Sets the target frame rate.
 		 *
-		 * This function handles user input and window events, such as resizing or closing.
-		 * It should be called frequently within the main loop.
+		 * @param framesPerSecond The frame rate to pace to, 0 disables pacing.
 		 */
-		void PollEvents() const;
+		void SetTargetFrameRate(double framesPerSecond);
 
 		/**
-		 * @brief Retrieves the address of an OpenGL function for the current context.
+		 * @brief Sets the target frame time.
 		 *
-		 * @return A pointer to the requested function.
+		 * @param nanoseconds The time between frames, 0 disables pacing.
 		 */
-		char* GetProcAddress(const char* name) const;
+		void SetTargetFrameTime(uint64_t nanoseconds);
+
+		uint64_t GetTargetFrameTime() const { return m_TargetFrameTime; }
 
 		/**
-		 * @brief Sets the callback function for window resizing.
-		 *
-		 * This callback is triggered when the window is resized.
-		 *
-		 * @param callback The function to be called when the window size changes.
+		 * @brief Blocks until the next frame deadline. Does nothing when pacing is disabled.
 		 */
-		void SetWindowResizeCallback(WindowResizeCallback callback);
+		void Wait();
 
-		/**
-		* @brief Sets the callback function when the window is closing.
-		*
-		* This callback is triggered when the window is closing.
-		*
-		* @param callback The function to close the window.
-		*/
-		void SetWindowCloseCallback(WindowCloseCallback callback);
+		const FramePacerStats& GetStats() const { return m_Stats; }
+		void ResetStats() { m_Stats = FramePacerStats(); }
+
+	private:
+		void UpdateSleepEstimate(uint64_t sleptFor);
+
+	private:
+		static constexpr uint64_t SleepSlice = 1000000; //Sleeps are issued 1ms at a time so every one is a calibration sample
+
+		uint64_t m_TargetFrameTime = 0;
+		uint64_t m_NextDeadline = 0;
+
+		//Running mean and variance of how long a SleepSlice sleep really takes
+		double m_SleepMean = 2.0 * SleepSlice;
+		double m_SleepVariance = 0.0;
+
+		FramePacerStats m_Stats;
+	};
 
+	/**
+	 * @brief Collects the timing zones recorded with SW_PROFILE_SCOPE and exports them.
+	 *
+	 * Zones are only recorded when SW_ENABLE_PROFILER is defined before including Swindow.h, otherwise the
+	 * macros compile to nothing and the trace is empty.
+	 */
+	class Profiler
+	{
+	public:
 		/**
-		 * @brief Sets the callback function for keyboard input.
+		 * @brief Writes every recorded zone as Chrome trace-event JSON, viewable in chrome://tracing or Perfetto.
 		 *
-		 * This callback is triggered when a key is pressed or released.
+		 * Zones still being written by other threads may be missing from the file.
 		 *
-		 * @param callback The function to handle key events.
+		 * @param path The file to write.
+		 * @return False if the file could not be opened.
 		 */
-		void SetWindowKeyCallback(WindowKeyCallback callback);
+		static bool WriteChromeTrace(const std::string& path);
 
 		/**
-		 * @brief Sets the callback function for mouse button events.
-		 *
-		 * This callback is triggered when a mouse button is pressed or released.
-		 *
-		 * @param callback The function to handle mouse button events.
+		 * @brief Discards every recorded zone. No other thread may be recording zones at the time.
 		 */
-		void SetWindowMouseCallback(WindowMouseCallback callback);
+		static void Clear();
 
 		/**
-		 * @brief Sets the callback function for mouse movement.
-		 *
-		 * This callback is triggered when the mouse moves within the window.
-		 *
-		 * @param callback The function to handle mouse movement events.
+		 * @brief Retrieves how many zones were lost because a thread's buffer was full.
 		 */
-		void SetWindowMouseMoveCallback(WindowMouseMoveCallback callback);
+		static uint64_t GetDroppedZoneCount();
+	};
 
-		void SetWindowCharacterCallback(WindowCharacterCallback callback);
+	enum class CaptureFormat : uint8_t
+	{
+		RawRGBA = 0, //Top-down RGBA8 frames back to back, without a header
+		Y4M,         //YUV4MPEG2 with full range 4:2:0 chroma, readable by ffmpeg and most players
+	};
+
+	/**
+	 * @brief Streams captured frames to a file on a writer thread.
+	 *
+	 * Submit copies the frame into a free buffer and returns; the writer thread converts it and writes it with
+	 * large sequential writes. When every buffer is still waiting for the disk the frame is dropped and counted,
+	 * so a slow disk never stalls the render thread. Every frame must have the size of the first one.
+	 *
+	 * Typical use: `window->SetCaptureCallback(sink.GetCallback());` followed by a RequestCapture every frame.
+	 */
+	class CaptureSink
+	{
+	public:
+		static constexpr size_t DefaultQueueDepth = 4;
+		static constexpr size_t MaxQueueDepth = 64;
+
+		~CaptureSink() { Close(); }
 
 		/**
-		 * @brief Sets the window size.
-		 *
-		 * This function updates the dimensions of the window.
+		 * @brief Creates the file and starts the writer thread.
 		 *
-		 * @param width The new width of the window.
-		 * @param height The new height of the window.
+		 * @param path The file to write.
+		 * @param format The file format.
+		 * @param frameRate The frame rate stored in Y4M headers.
+		 * @param queueDepth How many frames may wait for the writer before frames are dropped, up to MaxQueueDepth.
+		 * @return False if the file could not be created.
 		 */
-		void SetWindowSize(int width, int height);
+		bool Open(const std::string& path, CaptureFormat format, double frameRate = 60.0, size_t queueDepth = DefaultQueueDepth);
 
 		/**
-		 * @brief Retrieves the window description.
-		 *
-		 * @return The current window description.
+		 * @brief Writes the frames still queued, stops the writer thread and closes the file.
 		 */
-		WindowDescription GetWindowDescription() const { return m_WindowDescription; }
+		void Close();
+
+		bool IsOpen() const { return m_IsRunning; }
 
 		/**
-		 * @brief Retrieves the window callbacks.
+		 * @brief Queues a copy of the frame for the writer thread. Must always be called from the same thread.
 		 *
-		 * @return The set of callback functions associated with the window.
+		 * @return False if the frame was dropped.
+		 */
+		bool Submit(const CapturedFrame& frame);
+
+		/**
+		 * @brief Returns a capture callback that submits every frame. The sink must outlive the window using it.
+		 */
+		WindowCaptureCallback GetCallback() { return [this](const CapturedFrame& frame) { Submit(frame); }; }
+
+		uint64_t GetWrittenFrameCount() const { return m_Written; }
+
+		/**
+		 * @brief Retrieves how many frames were dropped because the writer could not keep up or their size changed.
 		 */
-		WindowCallbacks GetWindowCallbacks() const { return m_WindowCallbacks; }
+		uint64_t GetDroppedFrameCount() const { return m_Dropped; }
 
 	private:
-		WindowDescription m_WindowDescription;
-		WindowCallbacks m_WindowCallbacks;
-		Internal::NativeWindowPtr m_NativeWindow;
-		bool m_IsRunning;
-	};
+		void WriterLoop();
+		void WriteFrame(const uint8_t* pixels);
 
-	//Input
+	private:
+		std::FILE* m_File = nullptr;
+		std::thread m_WriterThread;
+		std::atomic<bool> m_IsRunning{ false };
+		CaptureFormat m_Format = CaptureFormat::RawRGBA;
+		double m_FrameRate = 60.0;
+		size_t m_QueueDepth = DefaultQueueDepth;
+
+		//Set by the first Submit, before any frame reaches the writer
+		int m_Width = 0;
+		int m_Height = 0;
+		std::vector<std::vector<uint8_t>> m_Frames;
+
+		//Indices into m_Frames: free ones go to Submit, filled ones to the writer
+		Internal::SPSCQueue<size_t, MaxQueueDepth> m_FreeFrames;
+		Internal::SPSCQueue<size_t, MaxQueueDepth> m_ReadyFrames;
+
+		std::vector<uint8_t> m_Converted; //Writer thread only
+		std::atomic<uint64_t> m_Written{ 0 };
+		std::atomic<uint64_t> m_Dropped{ 0 };
+	};
 
-	//Enum representing key codes
-	enum class KeyCode : uint8_t
+	/**
+	 * @brief A hidden OpenGL context that shares textures, buffers and other objects with a window's context.
+	 *
+	 * Made current on a worker thread to upload resources without stalling the render thread. Objects are
+	 * only safe to use from the window's context once the worker has finished them, e.g. with glFinish or
+	 * a fence, so publish them to the render thread after that. Render calls are not available here.
+	 */
+	class SharedContext
 	{
-		Unknown = 0,
+	public:
+		virtual ~SharedContext() = default;
 
-		A, B, C, D, E, F, G, H, I, J, K, L, M,
-		N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
+		/**
+		 * @brief Binds the context to the calling thread. It may be current on only one thread at a time.
+		 *
+		 * @return False if the context could not be made current.
+		 */
+		virtual bool MakeCurrent() = 0;
 
-		Num0, Num1, Num2, Num3, Num4, Num5, Num6, Num7, Num8, Num9,
+		/**
+		 * @brief Unbinds the context from the calling thread. Call before destroying it on another thread.
+		 */
+		virtual void ReleaseCurrent() = 0;
+	};
 
-		Escape, Enter, Space, Backspace, Tab, Shift, Ctrl, Alt,
-		Left, Right, Up, Down,
+	using SharedContextPtr = std::unique_ptr<SharedContext>;
 
-		F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+	struct WindowCallbacks
+	{
+		//Basic Window Callbacks
+		Swindow::WindowResizeCallback WindowResizeCallback;
+		Swindow::WindowCloseCallback WindowCloseCallback;
 
-		Count // Helper to get number of keys
+		//Input Callbacks
+		Swindow::WindowKeyCallback WindowKeyCallback;
+		Swindow::WindowMouseCallback WindowMouseCallback;
+		Swindow::WindowMouseMoveCallback WindowMouseMoveCallback;
+		Swindow::WindowCharacterCallback WindowCharacterCallback;
 	};
 
-	//Enum representing mouse buttons
-	enum class MouseButton
+	class Window
 	{
-		Unknown = 0,
-		LeftMouseButton,
-		RightMouseButton,
-	};
+	public:
+		/**
+		 * @brief Default constructor. Should not be used directly.
+		 *
+		 * Use Window::Create instead to properly initialize a window.
+		 */
+		Window() = default;
 
-	//Utility
+		/**
+		 * @brief Destroys the window if Destroy has not been called.
+		 */
+		~Window();
 
-	struct Colour
-	{
-		float R, G, B, A;
+		/**
+		 * @brief Creates the main application window.
+		 *
+		 * This function initializes and creates a new window with the specified settings.
+		 *
+		 * @param description The settings defining the properties of the window.
+		 * @return A shared pointer to the newly created window.
+		 */
+		static WindowPtr Create(const WindowDescription& description);
 
-		Colour(float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f)
-			: R(r), G(g), B(b), A(a) {}
-	};
+		/**
+		 * @brief Destroys the window.
+		 *
+		 * This function releases all resources associated with the window.
+		 */
+		void Destroy() const;
 
+		/**
+		 * @brief Checks if the window is still running.
+		 *
+		 * @return True if the window is running, false otherwise.
+		 */
+		bool GetIsRunning() const;
 
-	//Private
-	namespace Internal
-	{
-		class Logger
-		{
-		public:
-			static void Log(const std::string& message);
-		};
+		/**
+		 * @brief Sets the running state of the window.
+		 *
+		 * @param value True to keep the window running, false to stop it.
+		 */
+		void SetIsRunning(bool value);
 
-		class Error : public std::runtime_error
-		{
-		public:
-			Error(const std::string& message) : runtime_error(message) {}
-		};
+		/**
+		 * @brief Creates an OpenGL rendering context for the window.
+		 *
+		 * This function initializes an OpenGL context with the specified version.
+		 * It supports both modern and legacy OpenGL versions.
+		 *
+		 * @param major The major OpenGL version (default is 4).
+		 * @param minor The minor OpenGL version (default is 6).
+		 * @param legacy Set to true to use legacy OpenGL (1.x or earlier) (default is false).
+		 * @param shareWith A window whose context shares its objects with the new context (default is none).
+		 */
+		void CreateContext(int major = 4, int minor = 6, bool legacy = false, const WindowPtr& shareWith = nullptr) const;
 
-		class RenderContext
-		{
-		public:
-			/**
-			* @brief Sets the viewport size for rendering.
-			*
-			* This function updates the OpenGL viewport to match the given width and height.
-			* It ensures that all rendering operations are scaled appropriately within the window.
-			*
-			* @param width The width of the viewport in pixels.
-			* @param height The height of the viewport in pixels.
-			*/
-			static void SetViewportSize(int width, int height);
+		/**
+		 * @brief Creates a hidden context that shares objects with this window's context, for use on a worker thread.
+		 *
+		 * It has the same version as the window's context. Requires a context created with CreateContext.
+		 *
+		 * @return The context, or nullptr if it could not be created.
+		 */
+		SharedContextPtr CreateWorkerContext() const;
 
-			/**
-			* @brief Clears the current framebuffer.
-			*
-			* This function clears the color and depth buffers, preparing the screen for a new frame.
-			* It should be called at the beginning of each render loop.
-			*/
-			static void Clear();
+		/**
+		 * @brief Makes the window's OpenGL context current on the calling thread.
+		 *
+		 * Needed when rendering to several windows. Render calls use the batch state of the current context.
+		 */
+		void MakeContextCurrent() const;
 
-			/**
-			 * @brief Draws a colored quad at a specified position and scale.
-			 *
-			 * This function renders a simple quad (square) at the given position.
-			 * It can be used for basic UI elements, sprites, or debug rendering.
-			 *
-			 * @param x The X coordinate of the quad's position.
-			 * @param y The Y coordinate of the quad's position.
-			 * @param scale The scale factor of the quad (default is 1.0f).
-			 * @param colour The color of the quad (default is an empty/neutral color).
-			 */
-			static void DrawQuad(float x, float y, float scale = 1.0f, Colour colour = {});
-		};
+		/**
+		 * @brief Swaps the front and back buffers.
+		 *
+		 * This function is typically called at the end of a render loop to present the next frame.
+		 * If the window's frame pacer has a target, it waits for the next frame deadline before swapping.
+		 */
+		void SwapBuffers();
 
-		class NativeWindow
-		{
-		public:
-			virtual ~NativeWindow() = default;
+		/**
+		 * @brief Processes window events.
+		 *
+		 * This function handles user input and window events, such as resizing or closing.
+		 * It should be called frequently within the main loop.
+		 * With several windows, use PollAllEvents instead: the native queue is shared, so this call
+		 * also dispatches events that belong to the other windows.
+		 * Once the window has run a few frames, polling and dispatching to the callbacks do not allocate.
+		 */
+		void PollEvents();
 
-			static NativeWindowPtr Create(const WindowPtr& window);
-			virtual void Destroy() {}
+		/**
+		 * @brief Processes the events of every live window.
+		 *
+		 * Starts a new input frame on every window, pumps the shared native queue once and dispatches each
+		 * event to the window it belongs to, looked up by its native handle.
+		 */
+		static void PollAllEvents();
 
-			virtual void RefreshScreen() {}
-			virtual void PollEvents() {}
+		/**
+		 * @brief Sleeps until at least one event arrives, then processes events like PollEvents.
+		 *
+		 * Use this instead of PollEvents for applications that only need to redraw in response to input,
+		 * so an idle window does not keep a core busy.
+		 */
+		void WaitEvents();
 
-			virtual KeyCode ConvertNativeKeyCodes(int key) { return KeyCode::Unknown; }
+		/**
+		 * @brief Like WaitEvents, but returns after the timeout even if no event arrived.
+		 *
+		 * @param seconds The maximum time to wait.
+		 */
+		void WaitEventsTimeout(double seconds);
 
-			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false) {}
-			virtual void* GetExternalAddress(const char* name) { return nullptr; }
+		/**
+		 * @brief Wakes a thread blocked in WaitEvents or WaitEventsTimeout.
+		 *
+		 * Safe to call from any thread.
+		 */
+		void PostEmptyEvent() const;
 
-			WindowPtr GetWindow() const { return m_Window; }
+		/**
+		 * @brief Retrieves the address of an OpenGL function for the current context.
+		 *
+		 * @return A pointer to the requested function.
+		 */
+		char* GetProcAddress(const char* name) const;
 
-		protected:
-			WindowPtr m_Window;
-		};
+		/**
+		 * @brief Retrieves the platform window: the HWND on Windows or the X11 window id on Linux.
+		 *
+		 * @return The native handle, or 0 for headless windows.
+		 */
+		uintptr_t GetNativeHandle() const;
 
-#ifdef _WIN32
+		/**
+		 * @brief Retrieves the OpenGL functions resolved for this window's context.
+		 *
+		 * The table is filled in once by CreateContext, so calling through it costs no lookup.
+		 * Before a context exists every entry is nullptr.
+		 */
+		const GLFunctions& GetGLFunctions() const;
 
-		class Win32NativeWindow : public NativeWindow
-		{
-		public:
-			Win32NativeWindow(const WindowPtr& window);
+		/**
+		 * @brief Sets how many vertical blanks SwapBuffers waits for.
+		 *
+		 * 0 disables vsync, 1 enables it and a negative value enables adaptive vsync with the absolute value as interval.
+		 * Requires a context created with CreateContext.
+		 *
+		 * @param interval The swap interval.
+		 * @return False if the context does not support the requested interval.
+		 */
+		bool SetSwapInterval(int interval) const;
 
-			virtual ~Win32NativeWindow() override = default;
+		/**
+		 * @brief Retrieves which swap intervals the current context supports.
+		 */
+		SwapIntervalSupport GetSwapIntervalSupport() const;
+
+		/**
+		 * @brief Sets the callback function for window resizing.
+		 *
+		 * This callback is triggered when the window is resized.
+		 *
+		 * @param callback The function to be called when the window size changes.
+		 */
+		void SetWindowResizeCallback(WindowResizeCallback callback);
+
+		/**
+		* @brief Sets the callback function when the window is closing.
+		*
+		* This callback is triggered when the window is closing.
+		*
+		* @param callback The function to close the window.
+		*/
+		void SetWindowCloseCallback(WindowCloseCallback callback);
+
+		/**
+		 * @brief Sets the callback function for keyboard input.
+		 *
+		 * This callback is triggered when a key is pressed or released.
+		 *
+		 * @param callback The function to handle key events.
+		 */
+		void SetWindowKeyCallback(WindowKeyCallback callback);
+
+		/**
+		 * @brief Sets the callback function for mouse button events.
+		 *
+		 * This callback is triggered when a mouse button is pressed or released.
+		 *
+		 * @param callback The function to handle mouse button events.
+		 */
+		void SetWindowMouseCallback(WindowMouseCallback callback);
+
+		/**
+		 * @brief Sets the callback function for mouse movement.
+		 *
+		 * This callback is triggered when the mouse moves within the window.
+		 *
+		 * @param callback The function to handle mouse movement events.
+		 */
+		void SetWindowMouseMoveCallback(WindowMouseMoveCallback callback);
+
+		void SetWindowCharacterCallback(WindowCharacterCallback callback);
+
+		/**
+		 * @brief Sets the window size.
+		 *
+		 * This function updates the dimensions of the window.
+		 * A headless window recreates its render surface at the new size, and keeps the old size if that fails.
+		 *
+		 * @param width The new width of the window.
+		 * @param height The new height of the window.
+		 */
+		void SetWindowSize(int width, int height);
+
+		/**
+		 * @brief Retrieves the window description.
+		 *
+		 * Returned by reference so reading a field does not copy the title.
+		 *
+		 * @return The current window description.
+		 */
+		const WindowDescription& GetWindowDescription() const { return m_WindowDescription; }
+
+		/**
+		 * @brief Retrieves the current width of the window, updated by resize events.
+		 */
+		int GetWidth() const { return m_WindowDescription.Width; }
+
+		/**
+		 * @brief Retrieves the current height of the window, updated by resize events.
+		 */
+		int GetHeight() const { return m_WindowDescription.Height; }
+
+		/**
+		 * @brief Retrieves the window callbacks.
+		 *
+		 * Returned by reference so checking or invoking a callback never copies the std::function objects.
+		 *
+		 * @return The set of callback functions associated with the window.
+		 */
+		const WindowCallbacks& GetWindowCallbacks() const { return m_WindowCallbacks; }
+
+		/**
+		 * @brief Checks if a key is currently held down.
+		 *
+		 * The input queries below read a snapshot that is updated by PollEvents, so they are
+		 * constant time and never allocate.
+		 */
+		bool IsKeyDown(KeyCode key) const;
+
+		/**
+		 * @brief Checks if a key went down during the last PollEvents. Key repeats are not counted.
+		 */
+		bool WasKeyPressed(KeyCode key) const;
+
+		/**
+		 * @brief Checks if a key was released during the last PollEvents.
+		 */
+		bool WasKeyReleased(KeyCode key) const;
+
+		bool IsMouseButtonDown(MouseButton button) const;
+		bool WasMouseButtonPressed(MouseButton button) const;
+		bool WasMouseButtonReleased(MouseButton button) const;
+
+		/**
+		 * @brief Retrieves the mouse position in window coordinates.
+		 */
+		void GetMousePosition(int& x, int& y) const;
+
+		/**
+		 * @brief Retrieves how far the mouse moved between the last two PollEvents calls.
+		 */
+		void GetMouseDelta(int& x, int& y) const;
+
+		/**
+		 * @brief Retrieves the wheel movement accumulated during the last PollEvents, in notches.
+		 */
+		void GetMouseWheel(float& x, float& y) const;
+
+		/**
+		 * @brief Takes the oldest event from the event queue.
+		 *
+		 * Requires WindowDescription::QueueEvents. May be called from a different thread
+		 * than the one calling PollEvents, as long as only one thread drains the queue.
+		 *
+		 * @param event Receives the event.
+		 * @return False if the queue is empty.
+		 */
+		bool NextEvent(Event& event);
+
+		/**
+		 * @brief Dispatches a synthetic event as if the OS had sent it.
+		 *
+		 * The event takes the same path as native events: motion coalescing, the event queue, the input
+		 * snapshot and the callbacks. Must be called from the thread that calls PollEvents.
+		 *
+		 * @param event The event to dispatch, e.g. from Event::MakeKey.
+		 */
+		void InjectEvent(const Event& event);
+
+		/**
+		 * @brief Dispatches a batch of synthetic events in order. See InjectEvent.
+		 *
+		 * @param events The events to dispatch.
+		 * @param count The number of events.
+		 */
+		void InjectEvents(const Event* events, size_t count);
+
+		/**
+		 * @brief Queues a synthetic event for the backend to deliver, as if the OS had sent it. Safe to call from any thread.
+		 *
+		 * Unlike InjectEvent, the event goes through the native queue: it wakes WaitEvents, is delivered by the next
+		 * PollEvents and, with WindowDescription::EventThread, is forwarded by the event thread.
+		 * Only headless windows accept posted events.
+		 *
+		 * @param event The event to post.
+		 * @return False if the backend does not support posted events.
+		 */
+		bool PostEvent(const Event& event);
+
+		/**
+		 * @brief Starts recording every event the window dispatches, with timestamps, to a binary log.
+		 *
+		 * The log is written by a background thread. Recording stops with StopRecording or Destroy.
+		 *
+		 * @param path The file to write.
+		 * @return False if the file could not be opened.
+		 */
+		bool StartRecording(const std::string& path);
+
+		void StopRecording();
+		bool IsRecording() const { return m_Recorder != nullptr; }
+
+		/**
+		 * @brief Replays a log written by StartRecording through the normal dispatch path.
+		 *
+		 * Replayed events are dispatched by PollEvents, alongside any native events.
+		 *
+		 * @param path The log to replay. It is memory-mapped, not read into memory.
+		 * @param mode RealTime to keep the recorded timing, Fast to dispatch one recorded frame per PollEvents.
+		 * @return False if the file could not be opened or is not an event log.
+		 */
+		bool StartReplay(const std::string& path, ReplayMode mode = ReplayMode::RealTime);
+
+		void StopReplay();
+		bool IsReplaying() const { return m_Replay != nullptr; }
+
+		/**
+		 * @brief Retrieves how many records of the current or last replay were skipped because they are not valid events.
+		 */
+		size_t GetSkippedReplayEventCount() const { return m_SkippedReplayEventCount; }
+
+		/**
+		 * @brief Retrieves how many events were dropped because the event queue was full.
+		 */
+		size_t GetDroppedEventCount() const { return m_DroppedEventCount; }
+
+		/**
+		 * @brief Merges consecutive mouse motion into a single event.
+		 *
+		 * When enabled, motion received during PollEvents is held back until another kind of event arrives
+		 * or PollEvents finishes, and only the last position is dispatched. Every raw sample is still
+		 * available from GetMouseMotionSample, stamped with the time the OS sampled it.
+		 *
+		 * @param value True to coalesce motion, false to dispatch every sample (default).
+		 */
+		void SetMouseMotionCoalescing(bool value);
+
+		/**
+		 * @brief Retrieves how many mouse positions were kept from the last PollEvents.
+		 *
+		 * Only counted while motion coalescing is enabled. At most MotionHistoryCapacity samples are kept;
+		 * beyond that the oldest are overwritten.
+		 */
+		size_t GetMouseMotionHistorySize() const { return m_MotionHistoryCount; }
+
+		/**
+		 * @brief Retrieves a mouse position received during the last PollEvents.
+		 *
+		 * @param index 0 for the oldest kept sample, up to GetMouseMotionHistorySize() - 1 for the newest.
+		 */
+		const MouseMotionSample& GetMouseMotionSample(size_t index) const { return m_MotionHistory[(m_MotionHistoryStart + index) % MotionHistoryCapacity]; }
+
+		/**
+		 * @brief Retrieves the current time of the monotonic clock used for Swindow timestamps.
+		 *
+		 * @return The time in nanoseconds since an unspecified starting point.
+		 */
+		static uint64_t GetTime();
+
+		/**
+		 * @brief Retrieves the frame pacer used by SwapBuffers.
+		 *
+		 * Pacing is disabled until a target is set, e.g. `window->GetFramePacer().SetTargetFrameRate(144.0);`.
+		 */
+		FramePacer& GetFramePacer() { return m_FramePacer; }
+
+		/**
+		 * @brief Retrieves the time between the last two SwapBuffers calls.
+		 *
+		 * @return The frame time in seconds, or 0 before the second SwapBuffers.
+		 */
+		float GetDeltaTime() const { return static_cast<float>(m_LastFrameTime) * 1e-9f; }
+
+		/**
+		 * @brief Computes min, max, mean and percentile frame times over the recent frames.
+		 */
+		FrameStats GetFrameStats() const { return m_FrameHistory.ComputeStats(); }
+
+		/**
+		 * @brief Sets how many recent frames GetFrameStats covers. Discards the frames recorded so far.
+		 *
+		 * @param frameCount The number of frames to keep (default is 240).
+		 */
+		void SetFrameStatsWindow(size_t frameCount) { m_FrameHistory.SetCapacity(frameCount); }
+
+		/**
+		 * @brief Reads back the frame presented by the next SwapBuffers without stalling the GPU.
+		 *
+		 * The frame is delivered to the capture callback from a later SwapBuffers, usually one or two frames later.
+		 * If every buffer in the ring is still in flight the capture is dropped. Requires an OpenGL 3.2 context.
+		 */
+		void RequestCapture() { m_Capture.Request(); }
+
+		/**
+		 * @brief Sets the callback that receives captured frames.
+		 */
+		void SetCaptureCallback(const WindowCaptureCallback& callback) { m_Capture.SetCallback(callback); }
+
+		/**
+		 * @brief Sets how many captures can be in flight at once.
+		 *
+		 * More buffers tolerate more latency before captures are dropped, at the cost of memory.
+		 *
+		 * @param size The number of pixel buffers (default is 3).
+		 */
+		void SetCaptureRingSize(size_t size) { m_Capture.SetRingSize(size); }
+
+		/**
+		 * @brief Waits for every capture in flight and delivers it. Blocks until the GPU has finished them.
+		 */
+		void FlushCaptures();
+
+		/**
+		 * @brief Retrieves how many captures were dropped because every buffer was still in flight.
+		 */
+		size_t GetDroppedCaptureCount() const { return m_Capture.GetDroppedCount(); }
+
+	private:
+		friend class Internal::NativeWindow;
+
+		//The two halves of PollEvents around the native pump, so PollAllEvents can pump once for every window.
+		void BeginEventFrame();
+		void EndEventFrame();
+
+		//Entry point for every event from every backend. Applies motion coalescing before ProcessEvent.
+		void DispatchEvent(const Event& event);
+
+		//Queues the event, updates the input snapshot and invokes the matching callback.
+		void ProcessEvent(const Event& event);
+
+		//Dispatches the motion held back by coalescing, if any.
+		void FlushPendingMotion();
+
+		//Dispatches the replayed events that are due this frame.
+		void ReplayEvents();
+
+		//Dispatches one event from the replay log. OS sample times belong to the recording session, so motion is restamped on arrival.
+		void DispatchReplayedEvent(Event event);
+
+	private:
+		static constexpr size_t EventQueueCapacity = 1024;
+		static constexpr size_t DefaultFrameStatsWindow = 240;
+		static constexpr size_t MotionHistoryCapacity = 256;
+
+		WindowDescription m_WindowDescription;
+		WindowCallbacks m_WindowCallbacks;
+		Internal::NativeWindowPtr m_NativeWindow;
+		Internal::SPSCQueue<Event, EventQueueCapacity> m_EventQueue;
+		Internal::InputState m_InputState;
+		std::array<MouseMotionSample, MotionHistoryCapacity> m_MotionHistory; //Ring of the newest samples, starting at m_MotionHistoryStart
+		size_t m_MotionHistoryStart = 0;
+		size_t m_MotionHistoryCount = 0;
+		Event m_PendingMotion;
+		bool m_CoalesceMotion = false;
+		bool m_HasPendingMotion = false;
+		size_t m_DroppedEventCount = 0;
+		FramePacer m_FramePacer;
+		Internal::FrameTimeHistory m_FrameHistory;
+		uint64_t m_LastSwapTime = 0;
+		uint64_t m_LastFrameTime = 0;
+		uint64_t m_FrameIndex = 0;
+		mutable Internal::FrameCapture m_Capture; //Released by Destroy, which is const
+		std::unique_ptr<Internal::EventRecorder> m_Recorder;
+		std::unique_ptr<Internal::EventLog> m_Replay;
+		size_t m_ReplayPosition = 0;
+		uint64_t m_ReplayStartTime = 0;
+		ReplayMode m_ReplayMode = ReplayMode::RealTime;
+		uint32_t m_ReplayGeneration = 0; //Bumped by StartReplay and StopReplay, so ReplayEvents notices a log swapped by a callback
+		size_t m_SkippedReplayEventCount = 0;
+		bool m_IsRunning;
+	};
+
+	//Input
+
+	//Enum representing key codes
+	enum class KeyCode : uint8_t
+	{
+		Unknown = 0,
+
+		A, B, C, D, E, F, G, H, I, J, K, L, M,
+		N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
+
+		Num0, Num1, Num2, Num3, Num4, Num5, Num6, Num7, Num8, Num9,
+
+		Escape, Enter, Space, Backspace, Tab, Shift, Ctrl, Alt,
+		Left, Right, Up, Down,
+
+		F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+
+		Grave, Minus, Equal, LeftBracket, RightBracket, Backslash,
+		Semicolon, Apostrophe, Comma, Period, Slash,
+
+		CapsLock, ScrollLock, NumLock, PrintScreen, Pause,
+		Insert, Delete, Home, End, PageUp, PageDown,
+		Super, Menu,
+
+		Keypad0, Keypad1, Keypad2, Keypad3, Keypad4, Keypad5, Keypad6, Keypad7, Keypad8, Keypad9,
+		KeypadDecimal, KeypadDivide, KeypadMultiply, KeypadSubtract, KeypadAdd, KeypadEnter, KeypadEqual,
+
+		F13, F14, F15, F16, F17, F18, F19, F20, F21, F22, F23, F24,
+
+		Count // Helper to get number of keys
+	};
+
+	//Enum representing mouse buttons
+	enum class MouseButton
+	{
+		Unknown = 0,
+		LeftMouseButton,
+		RightMouseButton,
+		MiddleMouseButton, //Last value: InputState::ButtonMask and EventLog::IsValidEvent check against it
+	};
+
+	//Utility
+
+	struct Colour
+	{
+		float R, G, B, A;
+
+		Colour(float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f)
+			: R(r), G(g), B(b), A(a) {}
+	};
+
+
+	//Private
+	namespace Internal
+	{
+		//Every live window in creation order, used by Window::PollAllEvents
+		std::vector<Window*>& GetLiveWindows();
+
+		//Removes a window from the live windows. Returns false if it was not live.
+		bool UnregisterWindow(const Window* window);
+
+#ifndef SW_LOG_LEVEL
+#if defined(SWINDOW_RELEASE)
+#define SW_LOG_LEVEL 3 //Warning
+#elif defined(SWINDOW_DEBUG)
+#define SW_LOG_LEVEL 0 //Trace
+#else
+#define SW_LOG_LEVEL 2 //Info
+#endif
+#endif
+
+		/**
+		 * @brief Levelled logger that never blocks the calling thread.
+		 *
+		 * Messages are formatted into a slot of a lock-free ring and written to stdout by a logging thread.
+		 * When the ring is full the message is dropped and counted instead. Use the SW_LOG_* macros, which
+		 * compile messages below SW_LOG_LEVEL away and only evaluate their arguments for enabled levels.
+		 */
+		class Logger
+		{
+		public:
+			static constexpr size_t Capacity = 1024;      //Messages the ring holds; must be a power of two
+			static constexpr size_t MessageLength = 256;  //Longer messages are truncated
+
+			/**
+			 * @brief Formats a printf-style message and queues it for the logging thread.
+			 */
+			static void Write(LogLevel level, const char* format, ...) SW_PRINTF_FORMAT(2, 3);
+
+			/**
+			 * @brief Sets the least severe level written at runtime. Levels stripped at compile time stay stripped.
+			 */
+			static void SetLevel(LogLevel level) { GetLevelStorage() = level; }
+			static LogLevel GetLevel() { return GetLevelStorage(); }
+
+			static bool IsEnabled(LogLevel level) { return level >= GetLevelStorage().load(std::memory_order_relaxed); }
+
+			//Whether SW_LOG_LEVEL keeps the level. The threshold is a parameter rather than a literal in SW_LOG, so a level
+			//of 0 does not make every call site an always-true comparison under -Wtype-limits.
+			static constexpr bool IsCompiledIn(LogLevel level, int minimum = SW_LOG_LEVEL) { return static_cast<int>(level) >= minimum; }
+
+			/**
+			 * @brief Blocks until every message queued so far has been written.
+			 */
+			static void Flush();
+
+			/**
+			 * @brief Retrieves how many messages were dropped because the ring was full.
+			 */
+			static uint64_t GetDroppedCount();
+
+		private:
+			struct Entry
+			{
+				std::atomic<size_t> Sequence{ 0 };
+				LogLevel Level = LogLevel::Info;
+				char Message[MessageLength];
+			};
+
+			struct State;
+
+			static State& GetState();
+			static std::atomic<LogLevel>& GetLevelStorage();
+
+			static void DrainLoop(State& state);
+			static void Output(LogLevel level, const char* message);
+
+			//Registered with atexit: writes what is queued and makes later messages synchronous
+			static void Shutdown();
+		};
+
+	//Logs a printf-style message. The arguments are only evaluated when the level is enabled.
+#define SW_LOG(level, ...) \
+	do \
+	{ \
+		if (::Swindow::Internal::Logger::IsCompiledIn(level) && ::Swindow::Internal::Logger::IsEnabled(level)) \
+			::Swindow::Internal::Logger::Write(level, __VA_ARGS__); \
+	} while (0)
+
+#define SW_LOG_TRACE(...) SW_LOG(::Swindow::LogLevel::Trace, __VA_ARGS__)
+#define SW_LOG_DEBUG(...) SW_LOG(::Swindow::LogLevel::Debug, __VA_ARGS__)
+#define SW_LOG_INFO(...) SW_LOG(::Swindow::LogLevel::Info, __VA_ARGS__)
+#define SW_LOG_WARNING(...) SW_LOG(::Swindow::LogLevel::Warning, __VA_ARGS__)
+#define SW_LOG_ERROR(...) SW_LOG(::Swindow::LogLevel::Error, __VA_ARGS__)
+
+		class Error : public std::runtime_error
+		{
+		public:
+			Error(const std::string& message) : runtime_error(message) {}
+		};
+
+		//Checks for a whole extension name in a space separated extension string
+		bool HasExtension(const char* extensions, const char* name);
+
+		/**
+		 * @brief Zones recorded by one thread.
+		 *
+		 * Only the owning thread appends, publishing each zone through m_Count, so recording takes no lock.
+		 * Buffers are never freed, so a trace can still be written after the thread exits.
+		 */
+		class ProfileBuffer
+		{
+		public:
+			struct Zone
+			{
+				const char* Name; //Must be a string literal or otherwise outlive the profiler
+				uint64_t Start;
+				uint64_t End;
+			};
+
+			static constexpr size_t Capacity = 1 << 16;
+
+			explicit ProfileBuffer(uint32_t threadIndex) : m_Zones(new Zone[Capacity]), m_ThreadIndex(threadIndex) {}
+
+			void Record(const char* name, uint64_t start, uint64_t end);
+
+			//Returns the calling thread's buffer, registering it on first use
+			static ProfileBuffer& GetThreadBuffer();
+
+			//Every buffer registered so far. Guarded by GetRegistryMutex.
+			static std::vector<std::unique_ptr<ProfileBuffer>>& GetRegistry();
+			static std::mutex& GetRegistryMutex();
+
+		private:
+			friend class Swindow::Profiler;
+
+			std::unique_ptr<Zone[]> m_Zones;
+			std::atomic<size_t> m_Count{ 0 };
+			std::atomic<uint64_t> m_Dropped{ 0 };
+			uint32_t m_ThreadIndex;
+		};
+
+		/**
+		 * @brief Records the time between its construction and destruction as a zone.
+		 */
+		class ProfileZone
+		{
+		public:
+			explicit ProfileZone(const char* name);
+			~ProfileZone();
+
+		private:
+			const char* m_Name;
+			uint64_t m_Start;
+		};
+
+#define SW_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SW_PROFILE_CONCAT(a, b) SW_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SW_ENABLE_PROFILER
+	//Records the rest of the enclosing scope as a zone named `name`
+#define SW_PROFILE_SCOPE(name) ::Swindow::Internal::ProfileZone SW_PROFILE_CONCAT(swProfileZone, __LINE__)(name)
+#else
+#define SW_PROFILE_SCOPE(name)
+#endif
+
+#define SW_PROFILE_FUNCTION() SW_PROFILE_SCOPE(__FUNCTION__)
+
+		/**
+		 * @brief Dense native key to KeyCode lookup table.
+		 *
+		 * Built at compile time by each backend, so translating a key is a single array index.
+		 */
+		struct KeyTable
+		{
+			KeyCode Keys[256];
+
+			//Maps `count` consecutive native keys starting at `first` onto consecutive key codes starting at `code`
+			constexpr void MapRange(int first, int count, KeyCode code)
+			{
+				for (int i = 0; i < count; ++i)
+				{
+					Keys[first + i] = static_cast<KeyCode>(static_cast<int>(code) + i);
+				}
+			}
+		};
+
+		//OpenGL function loading
+
+#ifdef _WIN32
+#define SW_APIENTRY APIENTRY
+#else
+#define SW_APIENTRY
+#endif
+
+		// These values come from the OpenGL specification; GL.h on Windows only covers OpenGL 1.1
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER    0x8892
+#define GL_STREAM_DRAW     0x88E0
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_STREAM_READ       0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED           0x911A
+#define GL_CONDITION_SATISFIED        0x911C
+#define GL_SYNC_FLUSH_COMMANDS_BIT    0x00000001
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER   0x8B31
+#define GL_COMPILE_STATUS  0x8B81
+#define GL_LINK_STATUS     0x8B82
+#endif
+
+		//Every OpenGL entry point Swindow uses beyond OpenGL 1.1: (return type, name without the gl prefix, parameters)
+#define SW_GL_FUNCTIONS(X) \
+		X(void,   GenVertexArrays,         (GLsizei n, GLuint* arrays)) \
+		X(void,   DeleteVertexArrays,      (GLsizei n, const GLuint* arrays)) \
+		X(void,   BindVertexArray,         (GLuint array)) \
+		X(void,   GenBuffers,              (GLsizei n, GLuint* buffers)) \
+		X(void,   DeleteBuffers,           (GLsizei n, const GLuint* buffers)) \
+		X(void,   BindBuffer,              (GLenum target, GLuint buffer)) \
+		X(void,   BufferData,              (GLenum target, std::ptrdiff_t size, const void* data, GLenum usage)) \
+		X(void,   BufferSubData,           (GLenum target, std::ptrdiff_t offset, std::ptrdiff_t size, const void* data)) \
+		X(void*,  MapBufferRange,          (GLenum target, std::ptrdiff_t offset, std::ptrdiff_t length, GLbitfield access)) \
+		X(GLboolean, UnmapBuffer,          (GLenum target)) \
+		X(void*,  FenceSync,               (GLenum condition, GLbitfield flags)) \
+		X(GLenum, ClientWaitSync,          (void* sync, GLbitfield flags, uint64_t timeout)) \
+		X(void,   DeleteSync,              (void* sync)) \
+		X(void,   EnableVertexAttribArray, (GLuint index)) \
+		X(void,   VertexAttribPointer,     (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)) \
+		X(void,   VertexAttribDivisor,     (GLuint index, GLuint divisor)) \
+		X(void,   DrawArraysInstanced,     (GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)) \
+		X(GLuint, CreateShader,            (GLenum type)) \
+		X(void,   ShaderSource,            (GLuint shader, GLsizei count, const char* const* string, const GLint* length)) \
+		X(void,   CompileShader,           (GLuint shader)) \
+		X(void,   GetShaderiv,             (GLuint shader, GLenum pname, GLint* params)) \
+		X(void,   GetShaderInfoLog,        (GLuint shader, GLsizei bufSize, GLsizei* length, char* infoLog)) \
+		X(void,   DeleteShader,            (GLuint shader)) \
+		X(GLuint, CreateProgram,           ()) \
+		X(void,   AttachShader,            (GLuint program, GLuint shader)) \
+		X(void,   LinkProgram,             (GLuint program)) \
+		X(void,   GetProgramiv,            (GLuint program, GLenum pname, GLint* params)) \
+		X(void,   GetProgramInfoLog,       (GLuint program, GLsizei bufSize, GLsizei* length, char* infoLog)) \
+		X(void,   UseProgram,              (GLuint program)) \
+		X(void,   DeleteProgram,           (GLuint program))
+
+		/**
+		 * @brief Table of OpenGL entry points resolved for a context.
+		 *
+		 * Filled in by Window::CreateContext, so function pointers are looked up once instead of on every call.
+		 */
+		struct GLFunctions
+		{
+#define SW_GL_DECLARE(returnType, name, params) returnType (SW_APIENTRY* name) params = nullptr;
+			SW_GL_FUNCTIONS(SW_GL_DECLARE)
+#undef SW_GL_DECLARE
+
+			//True if every function in the table was found
+			bool Complete = false;
+
+			/**
+			 * @brief Resolves every function in the table in a single pass, for the context current on this thread.
+			 *
+			 * @return True if all functions were found.
+			 */
+			bool Load(const Window& window);
+		};
+
+		/**
+		 * @brief Returns the table for the context current on this thread, loading it only the first time a driver is seen.
+		 *
+		 * Tables are cached by backend, vendor, renderer and version, so every further context of the same driver
+		 * reuses the resolved pointers. The returned table lives until the program exits.
+		 */
+		inline const GLFunctions& AcquireGLFunctions(const Window& window);
+
+		//Makes a table the one Swindow's renderer uses on this thread
+		inline void SetCurrentGLFunctions(const GLFunctions* functions);
+
+		//Returns the table of the context made current through Swindow on this thread,
+		//or of the most recently created context for contexts made current elsewhere.
+		inline const GLFunctions& GetGLFunctions();
+
+		//Opens the system OpenGL library once and looks up exported entry points in it.
+		//Used when the platform's GetProcAddress does not return core functions.
+		class GLLibrary
+		{
+		public:
+			static void* GetSymbol(const char* name);
+
+		private:
+			GLLibrary();
+			~GLLibrary();
+
+			static GLLibrary& Get();
+
+#ifdef _WIN32
+			HMODULE m_Module = nullptr;
+#else
+			void* m_Module = nullptr;
+#endif
+		};
+
+		class RenderContext
+		{
+		public:
+			/**
+			* @brief Sets the viewport size for rendering.
+			*
+			* This function updates the OpenGL viewport to match the given width and height.
+			* It ensures that all rendering operations are scaled appropriately within the window.
+			*
+			* @param width The width of the viewport in pixels.
+			* @param height The height of the viewport in pixels.
+			*/
+			static void SetViewportSize(int width, int height);
+
+			/**
+			* @brief Clears the current framebuffer.
+			*
+			* This function clears the color and depth buffers, preparing the screen for a new frame.
+			* It should be called at the beginning of each render loop.
+			*/
+			static void Clear();
+
+			/**
+			 * @brief Draws a colored quad at a specified position and scale.
+			 *
+			 * This function renders a simple quad (square) at the given position.
+			 * It can be used for basic UI elements, sprites, or debug rendering.
+			 * Between BeginBatch and Flush the quad is only recorded; otherwise it is drawn immediately.
+			 *
+			 * @param x The X coordinate of the quad's position.
+			 * @param y The Y coordinate of the quad's position.
+			 * @param scale The scale factor of the quad (default is 1.0f).
+			 * @param colour The color of the quad (default is an empty/neutral color).
+			 */
+			static void DrawQuad(float x, float y, float scale = 1.0f, Colour colour = {});
+
+			/**
+			 * @brief Starts collecting quads into a batch.
+			 *
+			 * Every DrawQuad call until the next Flush is stored in a CPU-side instance list
+			 * instead of being drawn immediately. Instanced drawing needs an OpenGL 3.3 context;
+			 * on older contexts Flush falls back to drawing the quads one at a time.
+			 */
+			static void BeginBatch();
+
+			/**
+			 * @brief Draws every quad collected since BeginBatch and ends the batch.
+			 *
+			 * The quads are streamed into a single instance buffer and drawn with one instanced draw call.
+			 */
+			static void Flush();
+
+			/**
+			 * @brief Selects the batch state used by render calls on the calling thread.
+			 *
+			 * GL objects are not shared between contexts, so every context keeps its own batch.
+			 * Called by Window::CreateContext and Window::MakeContextCurrent.
+			 *
+			 * @param context Identifies the context, Swindow uses the owning native window.
+			 */
+			static void SetCurrentContext(const void* context);
+
+			/**
+			 * @brief Releases the GPU resources used for batching by a context.
+			 *
+			 * Called by Window::Destroy while the context is still current.
+			 */
+			static void Shutdown(const void* context);
+
+		private:
+			struct QuadInstance
+			{
+				float X, Y, Scale;
+				float R, G, B, A;
+			};
+
+			struct BatchData
+			{
+				std::vector<QuadInstance> Instances;
+				GLuint Program = 0;
+				GLuint VertexArray = 0;
+				GLuint InstanceBuffer = 0;
+				size_t BufferCapacity = 0; //Capacity of the GPU instance buffer in quads
+				bool IsActive = false;
+				bool IsUnsupported = false; //InitBatch failed once, so Flush draws the quads immediately instead
+			};
+
+			static BatchData& GetBatchData();
+			static std::unordered_map<const void*, BatchData>& GetBatches();
+			static BatchData*& GetCurrentBatch();
+			static bool InitBatch(BatchData& batch);
+		};
+
+		/**
+		 * @brief Maps a 32-bit millisecond OS event clock (X server time, GetMessageTime) onto Window::GetTime.
+		 *
+		 * The offset between the clocks is the smallest difference seen so far, i.e. the one measured on the
+		 * event delivered with the least delay. Only used by the thread pumping native events.
+		 */
+		class EventClock
+		{
+		public:
+			uint64_t ToTime(uint32_t milliseconds)
+			{
+				//Extend the counter across wrap-around, about every 49 days
+				if (milliseconds < m_Last && m_Last - milliseconds > 0x80000000u)
+				{
+					m_Epoch += 0x100000000ull;
+				}
+				m_Last = milliseconds;
+
+				const int64_t osTime = static_cast<int64_t>((m_Epoch + milliseconds) * 1000000ull);
+				const int64_t offset = static_cast<int64_t>(Window::GetTime()) - osTime;
+				if (!m_HasOffset || offset < m_Offset)
+				{
+					m_Offset = offset;
+					m_HasOffset = true;
+				}
+
+				return static_cast<uint64_t>(osTime + m_Offset);
+			}
+
+		private:
+			uint64_t m_Epoch = 0;
+			uint32_t m_Last = 0;
+			int64_t m_Offset = 0;
+			bool m_HasOffset = false;
+		};
+
+		class NativeWindow
+		{
+		public:
+			virtual ~NativeWindow() = default;
+
+			static NativeWindowPtr Create(Window* window);
+			virtual void Destroy() {}
+
+			virtual void RefreshScreen() {}
+			virtual void PollEvents() {}
+
+			//Blocks until native events are pending, WakeUp is called or the timeout, in seconds, expires. A negative timeout waits forever.
+			virtual void WaitForEvents(double timeout) {}
+
+			//Interrupts WaitForEvents. Must be safe to call from any thread.
+			virtual void WakeUp() {}
+
+			//Queues an event for the next PollEvents to deliver as if the OS had sent it. Must be safe to call from any thread.
+			virtual bool PostNativeEvent(const Event& event) { return false; }
+
+			//Called before the window takes a new size, so surfaces the backend sizes itself can follow. Returning false keeps the old size.
+			virtual bool ResizeSurface(int width, int height) { return true; }
+
+			virtual KeyCode ConvertNativeKeyCodes(int key) { return KeyCode::Unknown; }
+
+			//shareContext is the native context of a window of the same backend, or nullptr
+			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false, void* shareContext = nullptr) {}
+			virtual void MakeContextCurrent() {}
+			virtual void* GetNativeContext() const { return nullptr; }
+			virtual uintptr_t GetNativeHandle() const { return 0; }
+			virtual SharedContextPtr CreateWorkerContext() { return nullptr; }
+			virtual void* GetExternalAddress(const char* name) { return nullptr; }
+
+			virtual bool SetSwapInterval(int interval) { return false; }
+			SwapIntervalSupport GetSwapIntervalSupport() const { return m_SwapIntervalSupport; }
+
+			const GLFunctions* GetGLFunctions() const { return m_GLFunctions; }
+			void SetGLFunctions(const GLFunctions* functions) { m_GLFunctions = functions; }
+
+			Window* GetWindow() const { return m_Window; }
+
+			//Forwards a translated native event to the window's dispatch path, or to the render thread when the event thread is running.
+			void DispatchEvent(const Event& event);
+
+			//Converts the OS timestamp of a native event, in milliseconds, for Event::MouseMoveEvent::Time
+			uint64_t ConvertEventTime(uint32_t milliseconds) { return m_EventClock.ToTime(milliseconds); }
+
+			//Pumps the native queue, or drains the events forwarded by the event thread when it is running.
+			void ProcessEvents();
+
+			//Blocks until ProcessEvents has something to do, PostEmptyEvent is called or the timeout expires.
+			void WaitEvents(double timeout);
+			void PostEmptyEvent();
+
+			//Starts pumping native events on a dedicated thread. Returns once OnEventThreadStart has finished on that thread.
+			void StartEventThread();
+			void StopEventThread();
+
+		protected:
+			//Run on the event thread before it starts pumping and after it stops. Win32 creates and destroys its window here,
+			//because messages are only delivered to the thread that created the window.
+			virtual void OnEventThreadStart() {}
+			virtual void OnEventThreadStop() {}
+
+			bool IsEventThreadRunning() const { return m_EventThread.joinable(); }
+
+		protected:
+			//Not owning: the Window owns its native window, so a shared pointer here would keep both alive forever
+			Window* m_Window = nullptr;
+
+			//Filled in by the backend's CreateContext
+			SwapIntervalSupport m_SwapIntervalSupport;
+
+			//Version of the window's context, reused for worker contexts
+			struct ContextVersion
+			{
+				int Major = 0;
+				int Minor = 0;
+				bool Legacy = false;
+			};
+			ContextVersion m_ContextVersion;
+
+			//Set by Window::CreateContext, owned by the cache in AcquireGLFunctions
+			const GLFunctions* m_GLFunctions = nullptr;
+
+			EventClock m_EventClock;
+
+		private:
+			static constexpr size_t EventThreadQueueCapacity = 4096;
+			using EventThreadQueue = SPSCQueue<Event, EventThreadQueueCapacity>;
+
+			std::thread m_EventThread;
+			std::unique_ptr<EventThreadQueue> m_EventThreadQueue;
+			std::atomic<bool> m_EventThreadRunning{ false };
+
+			//Wakes the render thread waiting on the event thread queue
+			std::mutex m_WakeMutex;
+			std::condition_variable m_WakeCondition;
+			std::atomic<bool> m_IsWaiting{ false };
+			bool m_WakeRequested = false;
+		};
+
+#ifdef _WIN32
+
+		class Win32NativeWindow : public NativeWindow
+		{
+		public:
+			Win32NativeWindow(Window* window);
+
+			virtual ~Win32NativeWindow() override = default;
+
+			virtual void Destroy() override;
+
+			virtual void PollEvents() override;
+			virtual void RefreshScreen() override;
+
+			virtual void WaitForEvents(double timeout) override;
+			virtual void WakeUp() override;
+
+			virtual KeyCode ConvertNativeKeyCodes(int key) override { return TranslateKey(key); }
+
+			//Table lookup behind ConvertNativeKeyCodes. Needs no window, so it can be benchmarked on its own.
+			static KeyCode TranslateKey(int key);
+
+			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false, void* shareContext = nullptr) override;
+			virtual void MakeContextCurrent() override;
+			virtual void* GetNativeContext() const override { return m_OpenGLContext; }
+			virtual uintptr_t GetNativeHandle() const override { return reinterpret_cast<uintptr_t>(m_WindowHandle); }
+			virtual SharedContextPtr CreateWorkerContext() override;
+
+			virtual void* GetExternalAddress(const char* name) override;
+
+			virtual bool SetSwapInterval(int interval) override;
+
+		protected:
+			virtual void OnEventThreadStart() override;
+			virtual void OnEventThreadStop() override;
+
+		private:
+			void CreateNativeWindow();
+			void DestroyNativeWindow();
+
+			//Creates a context for the window's pixel format. Requires m_CreateContextAttribs for modern contexts.
+			HGLRC CreateWGLContext(int major, int minor, bool legacy, HGLRC shareContext);
+
+			//The class is shared by every window: registered by the first and unregistered by the last
+			static void RegisterWindowClass(HINSTANCE hInstance);
+			static void UnregisterWindowClass(HINSTANCE hInstance);
+
+			struct WindowClassUsers
+			{
+				std::mutex Mutex;
+				int Count = 0;
+			};
+			static WindowClassUsers& GetWindowClassUsers();
+		private:
+			HWND m_WindowHandle = nullptr;
+			HDC m_DeviceContext = nullptr;
+			HINSTANCE m_Instance = nullptr;
+			HGLRC m_OpenGLContext = nullptr;
+
+			BOOL(WINAPI* m_SwapIntervalEXT)(int) = nullptr;
+			HGLRC(WINAPI* m_CreateContextAttribs)(HDC, HGLRC, const int*) = nullptr;
+		};
+
+		class Win32SharedContext : public SharedContext
+		{
+		public:
+			Win32SharedContext(HDC deviceContext, HGLRC context) : m_DeviceContext(deviceContext), m_Context(context) {}
+			virtual ~Win32SharedContext() override { wglDeleteContext(m_Context); }
+
+			virtual bool MakeCurrent() override { return wglMakeCurrent(m_DeviceContext, m_Context) != FALSE; }
+			virtual void ReleaseCurrent() override { wglMakeCurrent(nullptr, nullptr); }
+
+		private:
+			//Any device context with the window's pixel format works, so the window's own is reused
+			HDC m_DeviceContext;
+			HGLRC m_Context;
+		};
+
+#endif
+
+#ifdef __linux__
+		/**
+		 * @brief An EGL display with the config, surface and context of one window.
+		 *
+		 * Used by the headless backend and by X11 windows created with WindowDescription::UseEGL.
+		 */
+		struct EGLState
+		{
+			EGLDisplay Display = EGL_NO_DISPLAY;
+			EGLConfig Config = nullptr;
+			EGLSurface Surface = EGL_NO_SURFACE;
+			EGLContext Context = EGL_NO_CONTEXT;
+
+			//Gets and initializes the display of a platform, e.g. EGL_PLATFORM_X11_EXT, or returns false
+			bool Initialize(EGLenum platform, void* nativeDisplay);
+
+			//Chooses an 8 bit RGBA desktop OpenGL config with depth and stencil for the surface type, e.g. EGL_WINDOW_BIT
+			bool ChooseConfig(EGLint surfaceType);
+
+			//Creates a context for Config, or returns EGL_NO_CONTEXT
+			EGLContext CreateContext(int major, int minor, bool legacy, EGLContext shareContext) const;
+
+			//Creates a context sharing with Context, without a surface when EGL_KHR_surfaceless_context is available
+			SharedContextPtr CreateWorkerContext(int major, int minor, bool legacy) const;
+
+			//Destroys the context and surface and releases the display
+			void Destroy();
+
+			//eglGetDisplay returns the same EGLDisplay for every window of a platform and eglTerminate is not reference
+			//counted, so a display is only terminated when its last user, window or worker context, is destroyed
+			static int AddDisplayUser(EGLDisplay display, int delta);
+		};
+
+		class EGLSharedContext : public SharedContext
+		{
+		public:
+			EGLSharedContext(EGLDisplay display, EGLContext context, EGLSurface surface);
+			virtual ~EGLSharedContext() override;
+
+			virtual bool MakeCurrent() override;
+			virtual void ReleaseCurrent() override;
+
+		private:
+			EGLDisplay m_Display;
+			EGLContext m_Context;
+			EGLSurface m_Surface; //EGL_NO_SURFACE when EGL_KHR_surfaceless_context is available
+		};
+#endif
+
+#ifdef __linux__
+		class X11NativeWindow;
+
+		/**
+		 * @brief A connection to the X server and the windows created on it.
+		 *
+		 * Windows pumped on the main thread share one connection, so a single pump reads every event and
+		 * hands it to its window through a lookup by native handle.
+		 */
+		class X11Connection
+		{
+		public:
+			X11Connection();
+			~X11Connection();
+
+			X11Connection(const X11Connection&) = delete;
+			X11Connection& operator=(const X11Connection&) = delete;
+
+			//Returns the connection shared by windows without an event thread, opening it if needed
+			static std::shared_ptr<X11Connection> AcquireShared();
+
+			Display* GetDisplay() const { return m_Display; }
+
+			void Register(::Window handle, X11NativeWindow* window) { m_Windows[handle] = window; }
+			void Unregister(::Window handle) { m_Windows.erase(handle); }
+
+			//Reads every pending event and dispatches it to the window it belongs to
+			void Pump();
+
+		private:
+			Display* m_Display = nullptr;
+			std::unordered_map<::Window, X11NativeWindow*> m_Windows;
+		};
+
+		class X11NativeWindow : public NativeWindow
+		{
+		public:
+			X11NativeWindow(Window* window);
+
+			virtual ~X11NativeWindow() override = default;
+
+			virtual void Destroy() override;
+
+			virtual void PollEvents() override;
+			virtual void RefreshScreen() override;
+
+			virtual void WaitForEvents(double timeout) override;
+			virtual void WakeUp() override;
+
+			virtual KeyCode ConvertNativeKeyCodes(int key) override { return TranslateKey(key); }
+
+			//Table lookup behind ConvertNativeKeyCodes. Needs no window, so it can be benchmarked on its own.
+			static KeyCode TranslateKey(int key);
+
+			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false, void* shareContext = nullptr) override;
+			virtual void MakeContextCurrent() override;
+			virtual void* GetNativeContext() const override;
+			virtual uintptr_t GetNativeHandle() const override { return static_cast<uintptr_t>(m_WindowHandle); }
+			virtual SharedContextPtr CreateWorkerContext() override;
+
+			virtual void* GetExternalAddress(const char* name) override;
+
+			virtual bool SetSwapInterval(int interval) override;
+
+			//Translates one event read by X11Connection::Pump
+			void ProcessNativeEvent(XEvent& event);
+
+		private:
+			static int IgnoreErrorHandler(Display* display, XErrorEvent* event);
+
+			//Creates a context for the window's framebuffer config, or returns nullptr
+			GLXContext CreateGLXContext(int major, int minor, bool legacy, GLXContext shareContext);
+
+			//Chooses the GLX framebuffer config, or the EGL config with UseEGL, and returns the matching visual
+			XVisualInfo* ChooseVisual(int screen);
+
+			//CreateContext for windows created with UseEGL
+			void CreateEGLContext(int major, int minor, bool legacy, EGLContext shareContext);
+		private:
+			std::shared_ptr<X11Connection> m_Connection;
+			Display* m_Display = nullptr; //Owned by m_Connection
+			::Window m_WindowHandle = 0;
+			Colormap m_Colormap = 0;
+			GLXFBConfig m_FrameBufferConfig = nullptr;
+			GLXContext m_OpenGLContext = nullptr;
+			Atom m_DeleteWindowAtom = 0;
+
+			//Only used with UseEGL, in place of the GLX config and context
+			bool m_UseEGL = false;
+			EGLState m_EGL;
+			int m_WakeEvent = -1; //eventfd polled next to the X connection so WakeUp can interrupt WaitForEvents
+
+			//GLX_EXT_swap_control is preferred, GLX_MESA_swap_control is the fallback
+			void(*m_SwapIntervalEXT)(Display*, GLXDrawable, int) = nullptr;
+			int(*m_SwapIntervalMESA)(unsigned int) = nullptr;
+
+			//Last size reported by the server, kept here so the pump never reads Window state from the event thread
+			int m_Width = 0;
+			int m_Height = 0;
+		};
+
+		class X11SharedContext : public SharedContext
+		{
+		public:
+			X11SharedContext(const std::shared_ptr<X11Connection>& connection, GLXContext context, GLXDrawable drawable)
+				: m_Connection(connection), m_Context(context), m_Drawable(drawable) {}
+			virtual ~X11SharedContext() override { glXDestroyContext(m_Connection->GetDisplay(), m_Context); }
+
+			virtual bool MakeCurrent() override { return glXMakeContextCurrent(m_Connection->GetDisplay(), m_Drawable, m_Drawable, m_Context); }
+			virtual void ReleaseCurrent() override { glXMakeContextCurrent(m_Connection->GetDisplay(), None, None, nullptr); }
+
+		private:
+			std::shared_ptr<X11Connection> m_Connection; //Keeps the display open while the context lives
+			GLXContext m_Context;
+			GLXDrawable m_Drawable; //None for OpenGL 3.0+ contexts, which need no drawable
+		};
+#endif
+
+		/**
+		 * @brief Offscreen window used when WindowDescription::Headless is set.
+		 *
+		 * There is no display server involved, so it never receives native input.
+		 * On Linux the OpenGL context renders into an EGL pbuffer of the window size, recreated when the window is resized.
+		 */
+		class HeadlessNativeWindow : public NativeWindow
+		{
+		public:
+			HeadlessNativeWindow(Window* window);
+
+			virtual ~HeadlessNativeWindow() override = default;
+
+			virtual void Destroy() override;
+
+			virtual void PollEvents() override;
+			virtual void RefreshScreen() override;
+
+			virtual void WaitForEvents(double timeout) override;
+			virtual void WakeUp() override;
+			virtual bool PostNativeEvent(const Event& event) override;
+			virtual bool ResizeSurface(int width, int height) override;
+
+			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false, void* shareContext = nullptr) override;
+			virtual void MakeContextCurrent() override;
+			virtual void* GetNativeContext() const override;
+			virtual SharedContextPtr CreateWorkerContext() override;
+
+			virtual void* GetExternalAddress(const char* name) override;
+
+		private:
+			std::mutex m_WakeMutex;
+			std::condition_variable m_WakeCondition;
+			bool m_WakeRequested = false;
+
+			//Stands in for the OS queue. Swapped with m_DeliveredEvents by PollEvents, so both keep their capacity.
+			std::vector<Event> m_PostedEvents;
+			std::vector<Event> m_DeliveredEvents;
+
+#ifdef __linux__
+			EGLState m_EGL;
+#endif
+		};
+
+	} //Namespace Internal
+
+
+	//Class Implementations
+
+	//Public
+
+#pragma region Window
+
+	inline WindowPtr Window::Create(const WindowDescription& description)
+	{
+
+		auto window = std::make_shared<Window>();
+		window->m_WindowDescription = description;
+
+		window->m_NativeWindow = Internal::NativeWindow::Create(window.get());
+
+		if (description.EventThread)
+		{
+			window->m_NativeWindow->StartEventThread();
+		}
+
+		window->m_IsRunning = true;
+
+		window->m_FrameHistory.SetCapacity(DefaultFrameStatsWindow);
+
+		Internal::GetLiveWindows().push_back(window.get());
+
+		SW_LOG_INFO("Created Window");
+
+		return window; //Return the parent window
+	}
+
+	inline void Window::Destroy() const
+	{
+		//Destroying twice, or after the destructor already did, is a no-op
+		if (!Internal::UnregisterWindow(this))
+			return;
+
+		if (m_Recorder)
+		{
+			m_Recorder->Stop();
+		}
+
+		m_NativeWindow->MakeContextCurrent();
+		Internal::RenderContext::Shutdown(m_NativeWindow.get());
+		m_Capture.Shutdown();
+
+		m_NativeWindow->Destroy();
+		SW_LOG_INFO("Destroyed Window");
+	}
+
+	inline bool Window::GetIsRunning() const
+	{
+		return m_IsRunning;
+	}
+
+	inline void Window::SetIsRunning(bool value)
+	{
+		m_IsRunning = value;
+	}
+
+	inline Window::~Window()
+	{
+		//A window that was never destroyed would leave the OS calling into freed memory
+		Destroy();
+	}
+
+	inline void Window::CreateContext(int major, int minor, bool legacy, const WindowPtr& shareWith) const
+	{
+		void* shareContext = nullptr;
+		if (shareWith)
+		{
+			//Contexts of different backends, e.g. headless and X11, or of GLX and EGL windows cannot share
+			const Internal::NativeWindow& shareNative = *shareWith->m_NativeWindow;
+			const bool sameAPI = m_WindowDescription.Headless || shareWith->m_WindowDescription.UseEGL == m_WindowDescription.UseEGL;
+			if (typeid(shareNative) == typeid(*m_NativeWindow) && sameAPI)
+			{
+				shareContext = shareNative.GetNativeContext();
+			}
+			else
+			{
+				SW_LOG_WARNING("Cannot share objects with a window of a different backend");
+			}
+		}
+
+		m_NativeWindow->CreateContext(major, minor, legacy, shareContext);
+		if (!m_NativeWindow->GetNativeContext())
+			return;
+
+		const Internal::GLFunctions& functions = Internal::AcquireGLFunctions(*this);
+		m_NativeWindow->SetGLFunctions(&functions);
+		Internal::SetCurrentGLFunctions(&functions);
+		Internal::RenderContext::SetCurrentContext(m_NativeWindow.get());
+
+		//Legacy contexts may legitimately miss newer functions, so a partial table is not an error there
+		if (!functions.Complete && !legacy)
+		{
+			SW_LOG_WARNING("Some OpenGL functions could not be loaded");
+		}
+	}
+
+	inline SharedContextPtr Window::CreateWorkerContext() const
+	{
+		SharedContextPtr context = m_NativeWindow->CreateWorkerContext();
+		if (!context)
+		{
+			SW_LOG_ERROR("Failed to create a worker context");
+		}
+
+		return context;
+	}
+
+	inline void Window::MakeContextCurrent() const
+	{
+		m_NativeWindow->MakeContextCurrent();
+		Internal::SetCurrentGLFunctions(m_NativeWindow->GetGLFunctions());
+		Internal::RenderContext::SetCurrentContext(m_NativeWindow.get());
+	}
+
+	inline void Window::PollEvents()
+	{
+		SW_PROFILE_SCOPE("Window::PollEvents");
+
+		BeginEventFrame();
+		m_NativeWindow->ProcessEvents();
+		EndEventFrame();
+	}
+
+	inline void Window::PollAllEvents()
+	{
+		SW_PROFILE_SCOPE("Window::PollAllEvents");
+
+		//Indexed loops: a callback may create or destroy windows while the queue is pumped
+		std::vector<Window*>& windows = Internal::GetLiveWindows();
+		for (size_t i = 0; i < windows.size(); i++)
+		{
+			windows[i]->BeginEventFrame();
+		}
+
+		//The first pump dispatches the events of every window sharing the queue, the others find it empty
+		for (size_t i = 0; i < windows.size(); i++)
+		{
+			windows[i]->m_NativeWindow->ProcessEvents();
+		}
+
+		for (size_t i = 0; i < windows.size(); i++)
+		{
+			windows[i]->EndEventFrame();
+		}
+	}
+
+	inline void Window::BeginEventFrame()
+	{
+		m_InputState.BeginFrame();
+		m_MotionHistoryStart = 0;
+		m_MotionHistoryCount = 0;
+
+		if (m_Recorder)
+		{
+			m_Recorder->MarkFrame();
+		}
+	}
+
+	inline void Window::EndEventFrame()
+	{
+		if (m_Replay)
+		{
+			ReplayEvents();
+		}
+
+		FlushPendingMotion();
+	}
+
+	inline void Window::WaitEvents()
+	{
+		WaitEventsTimeout(-1.0);
+	}
+
+	inline void Window::WaitEventsTimeout(double seconds)
+	{
+		m_NativeWindow->WaitEvents(seconds);
+
+		PollEvents();
+	}
+
+	inline void Window::PostEmptyEvent() const
+	{
+		m_NativeWindow->PostEmptyEvent();
+	}
+
+	inline bool Window::IsKeyDown(KeyCode key) const
+	{
+		return m_InputState.GetCurrent().Keys[static_cast<size_t>(key)];
+	}
+
+	inline bool Window::WasKeyPressed(KeyCode key) const
+	{
+		return m_InputState.GetCurrent().PressedKeys[static_cast<size_t>(key)];
+	}
+
+	inline bool Window::WasKeyReleased(KeyCode key) const
+	{
+		return m_InputState.GetCurrent().ReleasedKeys[static_cast<size_t>(key)];
+	}
+
+	inline bool Window::IsMouseButtonDown(MouseButton button) const
+	{
+		return (m_InputState.GetCurrent().Buttons & Internal::InputState::ButtonMask(button)) != 0;
+	}
+
+	inline bool Window::WasMouseButtonPressed(MouseButton button) const
+	{
+		return (m_InputState.GetCurrent().PressedButtons & Internal::InputState::ButtonMask(button)) != 0;
+	}
+
+	inline bool Window::WasMouseButtonReleased(MouseButton button) const
+	{
+		return (m_InputState.GetCurrent().ReleasedButtons & Internal::InputState::ButtonMask(button)) != 0;
+	}
+
+	inline void Window::GetMousePosition(int& x, int& y) const
+	{
+		x = m_InputState.GetCurrent().MouseX;
+		y = m_InputState.GetCurrent().MouseY;
+	}
+
+	inline void Window::GetMouseDelta(int& x, int& y) const
+	{
+		x = m_InputState.GetCurrent().MouseX - m_InputState.GetPrevious().MouseX;
+		y = m_InputState.GetCurrent().MouseY - m_InputState.GetPrevious().MouseY;
+	}
+
+	inline void Window::GetMouseWheel(float& x, float& y) const
+	{
+		x = m_InputState.GetCurrent().WheelX;
+		y = m_InputState.GetCurrent().WheelY;
+	}
+
+	inline char* Window::GetProcAddress(const char* name) const
+	{
+		return static_cast<char*>(m_NativeWindow->GetExternalAddress(name));
+	}
+
+	inline uintptr_t Window::GetNativeHandle() const
+	{
+		return m_NativeWindow->GetNativeHandle();
+	}
+
+	inline const GLFunctions& Window::GetGLFunctions() const
+	{
+		static const GLFunctions empty;
+		const GLFunctions* functions = m_NativeWindow->GetGLFunctions();
+		return functions ? *functions : empty;
+	}
+
+	inline bool Window::SetSwapInterval(int interval) const
+	{
+		const SwapIntervalSupport support = m_NativeWindow->GetSwapIntervalSupport();
+		if (!support.Interval || (interval < 0 && !support.Adaptive))
+		{
+			return false;
+		}
+
+		return m_NativeWindow->SetSwapInterval(interval);
+	}
+
+	inline SwapIntervalSupport Window::GetSwapIntervalSupport() const
+	{
+		return m_NativeWindow->GetSwapIntervalSupport();
+	}
+
+	inline void Window::SetWindowResizeCallback(WindowResizeCallback callback)
+	{
+		m_WindowCallbacks.WindowResizeCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowKeyCallback(WindowKeyCallback callback)
+	{
+		m_WindowCallbacks.WindowKeyCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowMouseCallback(WindowMouseCallback callback)
+	{
+		m_WindowCallbacks.WindowMouseCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowMouseMoveCallback(WindowMouseMoveCallback callback)
+	{
+		m_WindowCallbacks.WindowMouseMoveCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowCharacterCallback(WindowCharacterCallback callback)
+	{
+		m_WindowCallbacks.WindowCharacterCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowCloseCallback(WindowCloseCallback callback)
+	{
+		m_WindowCallbacks.WindowCloseCallback = std::move(callback);
+	}
+
+	inline void Window::SetWindowSize(int width, int height)
+	{
+		if (width == m_WindowDescription.Width && height == m_WindowDescription.Height)
+			return;
+
+		if (!m_NativeWindow->ResizeSurface(width, height))
+			return;
+
+		m_WindowDescription.Width = width;
+		m_WindowDescription.Height = height;
+	}
+
+	inline void Window::SwapBuffers()
+	{
+		{
+			SW_PROFILE_SCOPE("Window::FramePacer");
+			m_FramePacer.Wait();
+		}
+
+		//The back buffer is only defined until it is presented
+		m_Capture.Update(m_WindowDescription.Width, m_WindowDescription.Height, m_FrameIndex);
+
+		{
+			SW_PROFILE_SCOPE("Window::SwapBuffers");
+			m_NativeWindow->RefreshScreen();
+		}
+		m_FrameIndex++;
+
+		const uint64_t now = GetTime();
+		if (m_LastSwapTime != 0)
+		{
+			m_LastFrameTime = now - m_LastSwapTime;
+			m_FrameHistory.Push(m_LastFrameTime);
+		}
+		m_LastSwapTime = now;
+	}
+
+	inline void Window::FlushCaptures()
+	{
+		m_Capture.Flush();
+	}
+
+	inline bool Window::NextEvent(Event& event)
+	{
+		return m_EventQueue.Pop(event);
+	}
+
+	inline void Window::InjectEvent(const Event& event)
+	{
+		DispatchEvent(event);
+	}
+
+	inline bool Window::PostEvent(const Event& event)
+	{
+		return m_NativeWindow->PostNativeEvent(event);
+	}
+
+	inline bool Window::StartRecording(const std::string& path)
+	{
+		StopRecording();
+
+		std::unique_ptr<Internal::EventRecorder> recorder(new Internal::EventRecorder());
+		if (!recorder->Start(path))
+		{
+			return false;
+		}
+
+		m_Recorder = std::move(recorder);
+		return true;
+	}
+
+	inline void Window::StopRecording()
+	{
+		m_Recorder = nullptr;
+	}
+
+	inline bool Window::StartReplay(const std::string& path, ReplayMode mode)
+	{
+		std::unique_ptr<Internal::EventLog> log(new Internal::EventLog());
+		if (!log->Open(path))
+		{
+			return false;
+		}
+
+		m_Replay = std::move(log);
+		m_ReplayPosition = 0;
+		m_ReplayStartTime = GetTime();
+		m_ReplayMode = mode;
+		m_ReplayGeneration++;
+		m_SkippedReplayEventCount = 0;
+		return true;
+	}
+
+	inline void Window::StopReplay()
+	{
+		m_Replay = nullptr;
+		m_ReplayGeneration++;
+	}
+
+	inline void Window::InjectEvents(const Event* events, size_t count)
+	{
+		SW_PROFILE_SCOPE("Window::InjectEvents");
+
+		for (size_t i = 0; i < count; i++)
+		{
+			DispatchEvent(events[i]);
+		}
+	}
+
+	inline void Window::SetMouseMotionCoalescing(bool value)
+	{
+		if (!value)
+		{
+			FlushPendingMotion();
+		}
+
+		m_CoalesceMotion = value;
+	}
+
+	inline uint64_t Window::GetTime()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	inline void Window::DispatchEvent(const Event& event)
+	{
+		if (m_Recorder)
+		{
+			m_Recorder->Record(event);
+		}
+
+		if (event.Type == EventType::MouseMove)
+		{
+			if (m_CoalesceMotion)
+			{
+				//Injected events carry no OS time, so they are stamped on arrival
+				const uint64_t time = event.Motion.Time != 0 ? event.Motion.Time : GetTime();
+				m_MotionHistory[(m_MotionHistoryStart + m_MotionHistoryCount) % MotionHistoryCapacity] = { event.Motion.X, event.Motion.Y, time };
+
+				//Keep the newest samples if the application has not polled for a long time: a full ring overwrites its oldest
+				if (m_MotionHistoryCount < MotionHistoryCapacity)
+				{
+					m_MotionHistoryCount++;
+				}
+				else
+				{
+					m_MotionHistoryStart = (m_MotionHistoryStart + 1) % MotionHistoryCapacity;
+				}
+
+				m_PendingMotion = event;
+				m_HasPendingMotion = true;
+				return;
+			}
+		}
+		else
+		{
+			//Keep the order intact: the held back motion happened before this event
+			FlushPendingMotion();
+		}
+
+		ProcessEvent(event);
+	}
+
+	inline void Window::ReplayEvents()
+	{
+		SW_PROFILE_SCOPE("Window::ReplayEvents");
+
+		//A callback may stop the replay or start another one, which unmaps these records.
+		//The generation is checked after every dispatch, before the next record is read.
+		const uint32_t generation = m_ReplayGeneration;
+		const Internal::RecordedEvent* records = m_Replay->GetRecords();
+		const size_t count = m_Replay->GetCount();
+
+		if (m_ReplayMode == ReplayMode::RealTime)
+		{
+			const uint64_t elapsed = GetTime() - m_ReplayStartTime;
+			while (m_ReplayGeneration == generation && m_ReplayPosition < count && records[m_ReplayPosition].Timestamp <= elapsed)
+			{
+				const Event& event = records[m_ReplayPosition++].Data;
+				if (event.Type != EventType::Unknown)
+				{
+					DispatchReplayedEvent(event);
+				}
+			}
+		}
+		else
+		{
+			//Skip the frame markers, then dispatch up to the next one
+			while (m_ReplayPosition < count && records[m_ReplayPosition].Data.Type == EventType::Unknown)
+			{
+				m_ReplayPosition++;
+			}
+
+			while (m_ReplayGeneration == generation && m_ReplayPosition < count && records[m_ReplayPosition].Data.Type != EventType::Unknown)
+			{
+				DispatchReplayedEvent(records[m_ReplayPosition++].Data);
+			}
+		}
+
+		if (m_ReplayGeneration == generation && m_ReplayPosition == count)
+		{
+			m_Replay = nullptr;
+			SW_LOG_INFO("Finished replaying events");
+		}
+	}
+
+	inline void Window::DispatchReplayedEvent(Event event)
+	{
+		if (!Internal::EventLog::IsValidEvent(event))
+		{
+			if (m_SkippedReplayEventCount++ == 0)
+			{
+				SW_LOG_WARNING("Skipping invalid records in the event log");
+			}
+			return;
+		}
+
+		if (event.Type == EventType::MouseMove)
+		{
+			event.Motion.Time = 0;
+		}
+
+		DispatchEvent(event);
+	}
+
+	inline void Window::FlushPendingMotion()
+	{
+		if (m_HasPendingMotion)
+		{
+			m_HasPendingMotion = false;
+			ProcessEvent(m_PendingMotion);
+		}
+	}
+
+	inline void Window::ProcessEvent(const Event& event)
+	{
+		if (m_WindowDescription.QueueEvents && !m_EventQueue.Push(event))
+		{
+			++m_DroppedEventCount;
+		}
+
+		m_InputState.ProcessEvent(event);
+
+		switch (event.Type)
+		{
+		case EventType::Key:
+			if (m_WindowCallbacks.WindowKeyCallback)
+			{
+				SW_PROFILE_SCOPE("Window::KeyCallback");
+				m_WindowCallbacks.WindowKeyCallback(event.Key.Key, event.Key.IsPressed);
+			}
+			break;
+		case EventType::Character:
+			if (m_WindowCallbacks.WindowCharacterCallback)
+			{
+				SW_PROFILE_SCOPE("Window::CharacterCallback");
+				m_WindowCallbacks.WindowCharacterCallback(event.Character.Character);
+			}
+			break;
+		case EventType::MouseButton:
+			if (m_WindowCallbacks.WindowMouseCallback)
+			{
+				SW_PROFILE_SCOPE("Window::MouseCallback");
+				m_WindowCallbacks.WindowMouseCallback(event.Button.Button, event.Button.IsPressed);
+			}
+			break;
+		case EventType::MouseMove:
+			if (m_WindowCallbacks.WindowMouseMoveCallback)
+			{
+				SW_PROFILE_SCOPE("Window::MouseMoveCallback");
+				m_WindowCallbacks.WindowMouseMoveCallback(event.Motion.X, event.Motion.Y);
+			}
+			break;
+		case EventType::Resize:
+			SetWindowSize(event.Size.Width, event.Size.Height);
+
+			//Reports the size the window actually has, which stays the old one if the resize was rejected
+			if (m_WindowCallbacks.WindowResizeCallback)
+			{
+				SW_PROFILE_SCOPE("Window::ResizeCallback");
+				m_WindowCallbacks.WindowResizeCallback(m_WindowDescription.Width, m_WindowDescription.Height);
+			}
+			break;
+		case EventType::Close:
+			//If the user has the WindowCloseCallback: Then the application will check if that is true before returning.
+			if (m_WindowCallbacks.WindowCloseCallback)
+			{
+				SW_PROFILE_SCOPE("Window::CloseCallback");
+				if (m_WindowCallbacks.WindowCloseCallback())
+				{
+					SetIsRunning(false);
+				}
+				//Continue running the loop if returns false
+			}
+			else
+			{
+				SetIsRunning(false);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+#pragma endregion
+
+#pragma region FramePacer
+
+	inline void FramePacer::SetTargetFrameRate(double framesPerSecond)
+	{
+		SetTargetFrameTime(framesPerSecond > 0.0 ? static_cast<uint64_t>(1e9 / framesPerSecond) : 0);
+	}
+
+	inline void FramePacer::SetTargetFrameTime(uint64_t nanoseconds)
+	{
+		m_TargetFrameTime = nanoseconds;
+		m_NextDeadline = 0;
+	}
+
+	inline void FramePacer::Wait()
+	{
+		if (m_TargetFrameTime == 0)
+			return;
+
+		uint64_t now = Window::GetTime();
+
+		//The first frame only starts the cadence
+		if (m_NextDeadline == 0)
+		{
+			m_NextDeadline = now + m_TargetFrameTime;
+			return;
+		}
+
+		const uint64_t deadline = m_NextDeadline;
+		m_Stats.FrameCount++;
+
+		if (now >= deadline)
+		{
+			//Too late to pace this frame. Restart the cadence instead of rushing to catch up.
+			m_Stats.LateFrames++;
+			m_NextDeadline = now + m_TargetFrameTime;
+			return;
+		}
+
+		//Sleep while a whole slice, plus its expected overshoot, still fits before the deadline
+		const uint64_t sleepEstimate = static_cast<uint64_t>(m_SleepMean + std::sqrt(m_SleepVariance));
+		while (deadline - now > sleepEstimate)
+		{
+			std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(SleepSlice)));
+
+			const uint64_t after = Window::GetTime();
+			UpdateSleepEstimate(after - now);
+			m_Stats.SleepTime += after - now;
+			now = after;
+
+			if (now >= deadline)
+				break;
+		}
+
+		const uint64_t spinStart = now;
+		while (now < deadline)
+		{
+			std::this_thread::yield();
+			now = Window::GetTime();
+		}
+		m_Stats.SpinTime += now - spinStart;
+
+		const uint64_t error = now - deadline;
+		const uint64_t onTimeFrames = m_Stats.FrameCount - m_Stats.LateFrames;
+		m_Stats.MeanError += (static_cast<double>(error) - m_Stats.MeanError) / static_cast<double>(onTimeFrames);
+		if (error > m_Stats.MaxError)
+			m_Stats.MaxError = error;
+
+		//Advance from the deadline rather than from now so errors do not accumulate
+		m_NextDeadline = deadline + m_TargetFrameTime;
+	}
+
+	inline void FramePacer::UpdateSleepEstimate(uint64_t sleptFor)
+	{
+		//Exponential moving average, so the estimate follows changes in timer resolution
+		const double alpha = 0.1;
+		const double difference = static_cast<double>(sleptFor) - m_SleepMean;
+		m_SleepMean += alpha * difference;
+		m_SleepVariance = (1.0 - alpha) * (m_SleepVariance + alpha * difference * difference);
+	}
+
+#pragma endregion
+
+#pragma region Profiler
+
+	inline bool Profiler::WriteChromeTrace(const std::string& path)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "wb");
+		if (!file)
+		{
+			SW_LOG_ERROR("Failed to open profiler trace %s", path.c_str());
+			return false;
+		}
+
+		std::fputs("{\"traceEvents\":[", file);
+
+		bool first = true;
+		std::lock_guard<std::mutex> lock(Internal::ProfileBuffer::GetRegistryMutex());
+		for (const auto& buffer : Internal::ProfileBuffer::GetRegistry())
+		{
+			const size_t count = buffer->m_Count.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; i++)
+			{
+				const Internal::ProfileBuffer::Zone& zone = buffer->m_Zones[i];
+
+				std::fputs(first ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+				for (const char* c = zone.Name; *c; c++)
+				{
+					if (*c == '"' || *c == '\\')
+						std::fputc('\\', file);
+					std::fputc(*c, file);
+				}
+
+				//Chrome expects microseconds
+				std::fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					buffer->m_ThreadIndex, zone.Start / 1000.0, (zone.End - zone.Start) / 1000.0);
+				first = false;
+			}
+		}
+
+		std::fputs("\n]}\n", file);
+		std::fclose(file);
+		return true;
+	}
+
+	inline void Profiler::Clear()
+	{
+		std::lock_guard<std::mutex> lock(Internal::ProfileBuffer::GetRegistryMutex());
+		for (const auto& buffer : Internal::ProfileBuffer::GetRegistry())
+		{
+			buffer->m_Count.store(0, std::memory_order_release);
+			buffer->m_Dropped.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	inline uint64_t Profiler::GetDroppedZoneCount()
+	{
+		uint64_t dropped = 0;
+		std::lock_guard<std::mutex> lock(Internal::ProfileBuffer::GetRegistryMutex());
+		for (const auto& buffer : Internal::ProfileBuffer::GetRegistry())
+		{
+			dropped += buffer->m_Dropped.load(std::memory_order_relaxed);
+		}
+
+		return dropped;
+	}
+
+	namespace Internal
+	{
+		inline void ProfileBuffer::Record(const char* name, uint64_t start, uint64_t end)
+		{
+			const size_t count = m_Count.load(std::memory_order_relaxed);
+			if (count == Capacity)
+			{
+				m_Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			m_Zones[count] = { name, start, end };
+			m_Count.store(count + 1, std::memory_order_release);
+		}
+
+		inline ProfileBuffer& ProfileBuffer::GetThreadBuffer()
+		{
+			static thread_local ProfileBuffer* threadBuffer = nullptr;
+			if (!threadBuffer)
+			{
+				std::lock_guard<std::mutex> lock(GetRegistryMutex());
+				auto& registry = GetRegistry();
+				registry.emplace_back(new ProfileBuffer(static_cast<uint32_t>(registry.size())));
+				threadBuffer = registry.back().get();
+			}
+
+			return *threadBuffer;
+		}
+
+		inline std::vector<std::unique_ptr<ProfileBuffer>>& ProfileBuffer::GetRegistry()
+		{
+			static std::vector<std::unique_ptr<ProfileBuffer>> registry;
+			return registry;
+		}
+
+		inline std::mutex& ProfileBuffer::GetRegistryMutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		inline ProfileZone::ProfileZone(const char* name)
+			: m_Name(name), m_Start(Window::GetTime())
+		{
+		}
+
+		inline ProfileZone::~ProfileZone()
+		{
+			ProfileBuffer::GetThreadBuffer().Record(m_Name, m_Start, Window::GetTime());
+		}
+	} //Namespace Internal
+
+#pragma endregion
+
+#pragma region EventLog
+
+	namespace Internal
+	{
+		inline bool EventRecorder::Start(const std::string& path)
+		{
+			m_File = std::fopen(path.c_str(), "wb");
+			if (!m_File)
+			{
+				SW_LOG_ERROR("Failed to open event log %s", path.c_str());
+				return false;
+			}
+
+			//Large sequential writes: the writer thread hands over whole batches of records
+			std::setvbuf(m_File, nullptr, _IOFBF, 1 << 20);
+
+			const EventLogHeader header = { { 'S', 'W', 'E', 'V' }, EventLogVersion, sizeof(RecordedEvent), 0 };
+			std::fwrite(&header, sizeof(header), 1, m_File);
+
+			m_Queue.reset(new SPSCQueue<RecordedEvent, QueueCapacity>());
+			m_StartTime = Window::GetTime();
+			m_FrameHasEvents = true;
+			m_IsRunning = true;
+			m_WriterThread = std::thread(&EventRecorder::WriterLoop, this);
+			return true;
+		}
+
+		inline void EventRecorder::Stop()
+		{
+			if (!m_IsRunning)
+				return;
+
+			m_IsRunning = false;
+			m_WriterThread.join();
+
+			std::fclose(m_File);
+			m_File = nullptr;
+		}
+
+		inline void EventRecorder::Record(const Event& event)
+		{
+			Push({ Window::GetTime() - m_StartTime, event });
+			m_FrameHasEvents = true;
+		}
+
+		inline void EventRecorder::MarkFrame()
+		{
+			if (!m_FrameHasEvents)
+				return;
+
+			Push({ Window::GetTime() - m_StartTime, Event() });
+			m_FrameHasEvents = false;
+		}
+
+		inline void EventRecorder::Push(const RecordedEvent& record)
+		{
+			//Every event must reach the log, so wait for the writer rather than dropping
+			while (!m_Queue->Push(record))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		inline void EventRecorder::WriterLoop()
+		{
+			std::vector<RecordedEvent> batch(4096);
+
+			for (;;)
+			{
+				//Read the flag before draining, so nothing pushed before Stop is left behind
+				const bool isRunning = m_IsRunning.load();
+
+				size_t count = 0;
+				while (count < batch.size() && m_Queue->Pop(batch[count]))
+				{
+					count++;
+				}
+
+				if (count > 0)
+				{
+					std::fwrite(batch.data(), sizeof(RecordedEvent), count, m_File);
+				}
+				else if (!isRunning)
+				{
+					break;
+				}
+				else
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+
+			std::fflush(m_File);
+		}
+
+		inline bool EventLog::Open(const std::string& path)
+		{
+			Close();
+
+#ifdef _WIN32
+			m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			LARGE_INTEGER fileSize = {};
+			if (m_File == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_File, &fileSize))
+			{
+				SW_LOG_ERROR("Failed to open event log %s", path.c_str());
+				Close();
+				return false;
+			}
+
+			m_MappingSize = static_cast<size_t>(fileSize.QuadPart);
+			if (m_MappingSize >= sizeof(EventLogHeader))
+			{
+				m_FileMapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				m_Mapping = m_FileMapping ? MapViewOfFile(m_FileMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			}
+#else
+			const int file = open(path.c_str(), O_RDONLY);
+			struct stat fileStatus;
+			if (file < 0 || fstat(file, &fileStatus) != 0)
+			{
+				SW_LOG_ERROR("Failed to open event log %s", path.c_str());
+				if (file >= 0)
+					close(file);
+				return false;
+			}
+
+			m_MappingSize = static_cast<size_t>(fileStatus.st_size);
+			if (m_MappingSize >= sizeof(EventLogHeader))
+			{
+				void* mapping = mmap(nullptr, m_MappingSize, PROT_READ, MAP_PRIVATE, file, 0);
+				if (mapping != MAP_FAILED)
+				{
+					madvise(mapping, m_MappingSize, MADV_SEQUENTIAL);
+					m_Mapping = mapping;
+				}
+			}
+
+			//The mapping stays valid after the descriptor is closed
+			close(file);
+#endif
+
+			const EventLogHeader* header = static_cast<const EventLogHeader*>(m_Mapping);
+			if (!header || std::memcmp(header->Magic, "SWEV", 4) != 0 || header->Version != EventLogVersion || header->RecordSize != sizeof(RecordedEvent))
+			{
+				SW_LOG_ERROR("Not a valid event log %s", path.c_str());
+				Close();
+				return false;
+			}
+
+			m_Records = reinterpret_cast<const RecordedEvent*>(header + 1);
+			m_Count = (m_MappingSize - sizeof(EventLogHeader)) / sizeof(RecordedEvent);
+			return true;
+		}
+
+		inline bool EventLog::IsValidEvent(const Event& event)
+		{
+			//Reading a bool whose byte is not 0 or 1 is undefined, so look at the byte itself
+			const auto isBool = [](const bool& value)
+				{
+					uint8_t byte;
+					std::memcpy(&byte, &value, sizeof(byte));
+					return byte <= 1;
+				};
+
+			switch (event.Type)
+			{
+			case EventType::Key:
+				return isBool(event.Key.IsPressed);
+			case EventType::MouseButton:
+				return static_cast<int>(event.Button.Button) >= 0
+					&& static_cast<int>(event.Button.Button) <= static_cast<int>(MouseButton::MiddleMouseButton)
+					&& isBool(event.Button.IsPressed);
+			case EventType::MouseScroll:
+				return std::isfinite(event.Scroll.X) && std::isfinite(event.Scroll.Y);
+			case EventType::Character:
+			case EventType::MouseMove:
+			case EventType::Resize:
+			case EventType::Close:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		inline void EventLog::Close()
+		{
+#ifdef _WIN32
+			if (m_Mapping)
+				UnmapViewOfFile(m_Mapping);
+			if (m_FileMapping)
+				CloseHandle(m_FileMapping);
+			if (m_File != INVALID_HANDLE_VALUE)
+				CloseHandle(m_File);
+
+			m_FileMapping = nullptr;
+			m_File = INVALID_HANDLE_VALUE;
+#else
+			if (m_Mapping)
+				munmap(const_cast<void*>(m_Mapping), m_MappingSize);
+#endif
+
+			m_Mapping = nullptr;
+			m_MappingSize = 0;
+			m_Records = nullptr;
+			m_Count = 0;
+		}
+	} //Namespace Internal
+
+#pragma endregion
+
+#pragma region CaptureSink
+
+	namespace Internal
+	{
+		//Full range BT.601 in 8 bit fixed point, the colour space Y4M's C420jpeg declares
+		inline uint8_t ClampByte(int value)
+		{
+			return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+		}
+
+		inline uint8_t AverageByte(uint8_t a, uint8_t b)
+		{
+			return static_cast<uint8_t>((a + b + 1) >> 1);
+		}
+
+		inline uint8_t RGBToY(int r, int g, int b) { return ClampByte((77 * r + 150 * g + 29 * b + 128) >> 8); }
+		inline uint8_t RGBToU(int r, int g, int b) { return ClampByte(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128); }
+		inline uint8_t RGBToV(int r, int g, int b) { return ClampByte(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128); }
+
+#ifdef SW_SSE2
+		//(c0 * R + c1 * G + c2 * B + c3 * A + 128) >> 8 for each of the 4 RGBA8 pixels, as 32 bit integers
+		inline __m128i WeightedSum4(__m128i pixels, __m128i coefficients)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coefficients);
+			const __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coefficients);
+
+			//madd leaves R+G and B+A of each pixel in neighbouring lanes
+			const __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1));
+			const __m128i sum = _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+			return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(128)), 8);
+		}
+
+		//Averages 2x2 blocks of 8 pixels on two rows into 4 pixels, in lanes 0 and 2 of both results
+		inline void Average2x2(const uint8_t* top, const uint8_t* bottom, __m128i& first, __m128i& second)
+		{
+			const __m128i vertical0 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom)));
+			const __m128i vertical1 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(top + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + 16)));
+			first = _mm_avg_epu8(vertical0, _mm_srli_si128(vertical0, 4));
+			second = _mm_avg_epu8(vertical1, _mm_srli_si128(vertical1, 4));
+		}
+
+		//Chroma of the 4 averaged pixels in lanes 0 and 2 of first and second, packed into 4 bytes
+		inline int Chroma4(__m128i first, __m128i second, __m128i coefficients)
+		{
+			const __m128i a = _mm_shuffle_epi32(WeightedSum4(first, coefficients), _MM_SHUFFLE(3, 3, 2, 0));
+			const __m128i b = _mm_shuffle_epi32(WeightedSum4(second, coefficients), _MM_SHUFFLE(3, 3, 2, 0));
+			const __m128i values = _mm_add_epi32(_mm_unpacklo_epi64(a, b), _mm_set1_epi32(128));
+			const __m128i packed = _mm_packs_epi32(values, values);
+			return _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+		}
+#endif
+
+		/**
+		 * @brief Converts RGBA8 to planar 4:2:0 YUV, averaging chroma over 2x2 blocks.
+		 *
+		 * stride is the distance between rows in bytes and may be negative, e.g. to flip OpenGL's bottom-up rows.
+		 * The U and V planes hold ((width + 1) / 2) * ((height + 1) / 2) samples each.
+		 */
+		inline void ConvertRGBAToI420(const uint8_t* rgba, std::ptrdiff_t stride, int width, int height, uint8_t* y, uint8_t* u, uint8_t* v)
+		{
+			for (int row = 0; row < height; row++)
+			{
+				const uint8_t* source = rgba + row * stride;
+				uint8_t* destination = y + static_cast<size_t>(row) * width;
+				int x = 0;
+
+#ifdef SW_SSE2
+				const __m128i lumaCoefficients = _mm_setr_epi16(77, 150, 29, 0, 77, 150, 29, 0);
+				for (; x + 8 <= width; x += 8)
+				{
+					const __m128i first = WeightedSum4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 4)), lumaCoefficients);
+					const __m128i second = WeightedSum4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x * 4 + 16)), lumaCoefficients);
+					const __m128i packed = _mm_packs_epi32(first, second);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(destination + x), _mm_packus_epi16(packed, packed));
+				}
+#endif
+
+				for (; x < width; x++)
+				{
+					const uint8_t* pixel = source + x * 4;
+					destination[x] = RGBToY(pixel[0], pixel[1], pixel[2]);
+				}
+			}
+
+			const int chromaWidth = (width + 1) / 2;
+			const int chromaHeight = (height + 1) / 2;
+
+			for (int chromaRow = 0; chromaRow < chromaHeight; chromaRow++)
+			{
+				//The last row and column are repeated when the size is odd
+				const int topRow = chromaRow * 2;
+				const int bottomRow = topRow + 1 < height ? topRow + 1 : topRow;
+				const uint8_t* top = rgba + topRow * stride;
+				const uint8_t* bottom = rgba + bottomRow * stride;
+				uint8_t* uRow = u + static_cast<size_t>(chromaRow) * chromaWidth;
+				uint8_t* vRow = v + static_cast<size_t>(chromaRow) * chromaWidth;
+				int x = 0;
+
+#ifdef SW_SSE2
+				const __m128i uCoefficients = _mm_setr_epi16(-43, -85, 128, 0, -43, -85, 128, 0);
+				const __m128i vCoefficients = _mm_setr_epi16(128, -107, -21, 0, 128, -107, -21, 0);
+				for (; x * 2 + 8 <= width; x += 4)
+				{
+					__m128i first, second;
+					Average2x2(top + x * 8, bottom + x * 8, first, second);
+
+					const int uValues = Chroma4(first, second, uCoefficients);
+					const int vValues = Chroma4(first, second, vCoefficients);
+					std::memcpy(uRow + x, &uValues, 4);
+					std::memcpy(vRow + x, &vValues, 4);
+				}
+#endif
+
+				for (; x < chromaWidth; x++)
+				{
+					const int left = x * 2;
+					const int right = left + 1 < width ? left + 1 : left;
+
+					uint8_t average[3];
+					for (int channel = 0; channel < 3; channel++)
+					{
+						//Same rounding order as the vector path: vertical pairs first, then horizontal
+						average[channel] = AverageByte(
+							AverageByte(top[left * 4 + channel], bottom[left * 4 + channel]),
+							AverageByte(top[right * 4 + channel], bottom[right * 4 + channel]));
+					}
+
+					uRow[x] = RGBToU(average[0], average[1], average[2]);
+					vRow[x] = RGBToV(average[0], average[1], average[2]);
+				}
+			}
+		}
+	}//Namespace Internal
+
+	inline bool CaptureSink::Open(const std::string& path, CaptureFormat format, double frameRate, size_t queueDepth)
+	{
+		Close();
+
+		m_File = std::fopen(path.c_str(), "wb");
+		if (!m_File)
+		{
+			SW_LOG_ERROR("Failed to open capture file %s", path.c_str());
+			return false;
+		}
+
+		//Whole frames are handed to fwrite, so a large buffer turns them into few, large sequential writes
+		std::setvbuf(m_File, nullptr, _IOFBF, 4 << 20);
+
+		m_Format = format;
+		m_FrameRate = frameRate > 0.0 ? frameRate : 60.0;
+		m_QueueDepth = queueDepth == 0 ? 1 : (queueDepth > MaxQueueDepth ? MaxQueueDepth : queueDepth);
+		m_Width = 0;
+		m_Height = 0;
+		m_Frames.clear();
+		m_Written = 0;
+		m_Dropped = 0;
+
+		for (size_t i = 0; i < m_QueueDepth; i++)
+		{
+			m_FreeFrames.Push(i);
+		}
+
+		m_IsRunning = true;
+		m_WriterThread = std::thread(&CaptureSink::WriterLoop, this);
+		return true;
+	}
+
+	inline void CaptureSink::Close()
+	{
+		if (!m_IsRunning)
+			return;
+
+		m_IsRunning = false;
+		m_WriterThread.join();
+
+		std::fclose(m_File);
+		m_File = nullptr;
+
+		size_t index;
+		while (m_FreeFrames.Pop(index)) {}
+		while (m_ReadyFrames.Pop(index)) {}
+	}
+
+	inline bool CaptureSink::Submit(const CapturedFrame& frame)
+	{
+		SW_PROFILE_SCOPE("CaptureSink::Submit");
+
+		if (!m_IsRunning)
+			return false;
+
+		//The buffers are allocated once, for the size of the first frame
+		if (m_Frames.empty())
+		{
+			m_Width = frame.Width;
+			m_Height = frame.Height;
+			m_Frames.resize(m_QueueDepth);
+			for (std::vector<uint8_t>& buffer : m_Frames)
+			{
+				buffer.resize(static_cast<size_t>(m_Width) * static_cast<size_t>(m_Height) * 4);
+			}
+		}
+
+		size_t index;
+		if (frame.Width != m_Width || frame.Height != m_Height || !m_FreeFrames.Pop(index))
+		{
+			m_Dropped++;
+			return false;
+		}
+
+		std::memcpy(m_Frames[index].data(), frame.Pixels, m_Frames[index].size());
+		m_ReadyFrames.Push(index);
+		return true;
+	}
+
+	inline void CaptureSink::WriterLoop()
+	{
+		for (;;)
+		{
+			//Read the flag before draining, so nothing submitted before Close is left behind
+			const bool isRunning = m_IsRunning.load();
+
+			size_t index;
+			if (m_ReadyFrames.Pop(index))
+			{
+				WriteFrame(m_Frames[index].data());
+				m_FreeFrames.Push(index);
+				m_Written++;
+			}
+			else if (!isRunning)
+			{
+				break;
+			}
+			else
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		std::fflush(m_File);
+	}
+
+	inline void CaptureSink::WriteFrame(const uint8_t* pixels)
+	{
+		SW_PROFILE_SCOPE("CaptureSink::WriteFrame");
+
+		const size_t rowSize = static_cast<size_t>(m_Width) * 4;
+		const uint8_t* topRow = pixels + rowSize * (m_Height - 1);
+
+		if (m_Format == CaptureFormat::RawRGBA)
+		{
+			//Captured rows are bottom-up
+			for (int row = 0; row < m_Height; row++)
+			{
+				std::fwrite(topRow - rowSize * row, 1, rowSize, m_File);
+			}
+			return;
+		}
+
+		if (m_Written == 0)
+		{
+			//The frame rate is stored as a fraction, in thousandths of a frame
+			const unsigned long long numerator = static_cast<unsigned long long>(m_FrameRate * 1000.0 + 0.5);
+			std::fprintf(m_File, "YUV4MPEG2 W%d H%d F%llu:1000 Ip A1:1 C420jpeg\n", m_Width, m_Height, numerator);
+		}
+
+		const size_t lumaSize = static_cast<size_t>(m_Width) * m_Height;
+		const size_t chromaSize = static_cast<size_t>((m_Width + 1) / 2) * ((m_Height + 1) / 2);
+		m_Converted.resize(lumaSize + chromaSize * 2);
+
+		uint8_t* y = m_Converted.data();
+		Internal::ConvertRGBAToI420(topRow, -static_cast<std::ptrdiff_t>(rowSize), m_Width, m_Height, y, y + lumaSize, y + lumaSize + chromaSize);
+
+		std::fputs("FRAME\n", m_File);
+		std::fwrite(m_Converted.data(), 1, m_Converted.size(), m_File);
+	}
+
+#pragma endregion
+
+	//Private
+	namespace Internal
+	{
+		inline std::vector<Window*>& GetLiveWindows()
+		{
+			static std::vector<Window*> windows;
+			return windows;
+		}
+
+		inline bool UnregisterWindow(const Window* window)
+		{
+			std::vector<Window*>& windows = GetLiveWindows();
+			for (auto it = windows.begin(); it != windows.end(); ++it)
+			{
+				if (*it == window)
+				{
+					windows.erase(it);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		struct Logger::State
+		{
+			//Bounded multi-producer queue: a slot is free for position p when its Sequence is p,
+			//and filled when it is p + 1. Only the logging thread reads.
+			std::unique_ptr<Entry[]> Entries{ new Entry[Capacity] };
+			std::atomic<size_t> EnqueuePosition{ 0 };
+			size_t DequeuePosition = 0;
+			std::atomic<size_t> Written{ 0 };
+			std::atomic<uint64_t> Dropped{ 0 };
+
+			std::mutex WakeMutex;
+			std::condition_variable WakeCondition;
+			std::atomic<bool> IsSleeping{ false };
+			std::atomic<bool> IsSynchronous{ false };
+
+			//Threads blocked in Flush, waiting on FlushCondition under WakeMutex for Written to advance
+			std::condition_variable FlushCondition;
+			std::atomic<int> FlushWaiters{ 0 };
+
+			State()
+			{
+				for (size_t i = 0; i < Capacity; i++)
+				{
+					Entries[i].Sequence.store(i, std::memory_order_relaxed);
+				}
+
+				std::thread(&Logger::DrainLoop, std::ref(*this)).detach();
+				std::atexit(&Logger::Shutdown);
+			}
+		};
+
+		inline Logger::State& Logger::GetState()
+		{
+			//Never destroyed, so windows destroyed during static destruction can still log
+			static State* state = new State();
+			return *state;
+		}
+
+		inline std::atomic<LogLevel>& Logger::GetLevelStorage()
+		{
+			static std::atomic<LogLevel> level{ static_cast<LogLevel>(SW_LOG_LEVEL) };
+			return level;
+		}
+
+		inline void Logger::Write(LogLevel level, const char* format, ...)
+		{
+			State& state = GetState();
+
+			va_list arguments;
+			va_start(arguments, format);
+
+			if (state.IsSynchronous)
+			{
+				char message[MessageLength];
+				std::vsnprintf(message, sizeof(message), format, arguments);
+				va_end(arguments);
+				Output(level, message);
+				return;
+			}
+
+			//Claim a slot; a full ring drops the message rather than waiting
+			size_t position = state.EnqueuePosition.load(std::memory_order_relaxed);
+			Entry* entry = nullptr;
+			for (;;)
+			{
+				entry = &state.Entries[position & (Capacity - 1)];
+				const size_t sequence = entry->Sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+				if (difference == 0)
+				{
+					if (state.EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+				{
+					va_end(arguments);
+					state.Dropped++;
+					return;
+				}
+				else
+				{
+					position = state.EnqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			entry->Level = level;
+			std::vsnprintf(entry->Message, MessageLength, format, arguments);
+			va_end(arguments);
+			entry->Sequence.store(position + 1, std::memory_order_release);
+
+			//Only wake the logging thread when it is asleep; notifying never blocks
+			if (state.IsSleeping)
+			{
+				state.WakeCondition.notify_one();
+			}
+		}
+
+		inline void Logger::DrainLoop(State& state)
+		{
+			for (;;)
+			{
+				Entry& entry = state.Entries[state.DequeuePosition & (Capacity - 1)];
+				if (entry.Sequence.load(std::memory_order_acquire) == state.DequeuePosition + 1)
+				{
+					Output(entry.Level, entry.Message);
+					entry.Sequence.store(state.DequeuePosition + Capacity, std::memory_order_release);
+					state.DequeuePosition++;
+					state.Written = state.DequeuePosition;
+
+					//Written is stored before FlushWaiters is read, and Flush does the opposite, so one of them sees the other
+					if (state.FlushWaiters > 0)
+					{
+						std::lock_guard<std::mutex> lock(state.WakeMutex);
+						state.FlushCondition.notify_all();
+					}
+					continue;
+				}
+
+				std::fflush(stdout);
+
+				//Re-check after announcing the sleep, so a message published in between is not missed
+				std::unique_lock<std::mutex> lock(state.WakeMutex);
+				state.IsSleeping = true;
+				if (entry.Sequence.load(std::memory_order_acquire) != state.DequeuePosition + 1)
+				{
+					state.WakeCondition.wait_for(lock, std::chrono::milliseconds(100));
+				}
+				state.IsSleeping = false;
+			}
+		}
+
+		inline void Logger::Output(LogLevel level, const char* message)
+		{
+			static const char* const names[] = { "Trace", "Debug", "Info", "Warning", "Error", "Off" };
+			std::fprintf(stdout, "[Swindow] [%s] %s\n", names[static_cast<int>(level)], message);
+		}
+
+		inline void Logger::Flush()
+		{
+			State& state = GetState();
+			if (state.IsSynchronous)
+			{
+				std::fflush(stdout);
+				return;
+			}
+
+			//Messages claimed but not yet written; dropped ones never claimed a position
+			const size_t target = state.EnqueuePosition.load();
+			if (state.Written >= target)
+				return;
+
+			state.FlushWaiters++;
+			{
+				std::unique_lock<std::mutex> lock(state.WakeMutex);
+				state.WakeCondition.notify_one();
+				state.FlushCondition.wait(lock, [&state, target]() { return state.Written >= target; });
+			}
+			state.FlushWaiters--;
+		}
+
+		inline uint64_t Logger::GetDroppedCount()
+		{
+			return GetState().Dropped;
+		}
+
+		inline void Logger::Shutdown()
+		{
+			Flush();
+			GetState().IsSynchronous = true;
+			std::fflush(stdout);
+		}
+
+		inline bool HasExtension(const char* extensions, const char* name)
+		{
+			if (!extensions)
+				return false;
+
+			const size_t length = std::strlen(name);
+			for (const char* found = std::strstr(extensions, name); found; found = std::strstr(found + length, name))
+			{
+				const bool startsWord = (found == extensions) || (found[-1] == ' ');
+				const bool endsWord = (found[length] == ' ') || (found[length] == '\0');
+				if (startsWord && endsWord)
+					return true;
+			}
+
+			return false;
+		}
+
+		inline void FrameTimeHistory::SetCapacity(size_t capacity)
+		{
+			m_Samples.assign(capacity, 0);
+			m_Sorted.assign(capacity, 0);
+			m_Next = 0;
+			m_Count = 0;
+		}
+
+		inline void FrameTimeHistory::Push(uint64_t frameTime)
+		{
+			if (m_Samples.empty())
+				return;
+
+			m_Samples[m_Next] = frameTime;
+			m_Next = (m_Next + 1) % m_Samples.size();
+			if (m_Count < m_Samples.size())
+				m_Count++;
+		}
+
+		inline FrameStats FrameTimeHistory::ComputeStats() const
+		{
+			FrameStats stats;
+			stats.FrameCount = m_Count;
+			if (m_Count == 0)
+				return stats;
+
+			//Until the ring wraps, the recorded frames are the first m_Count entries
+			std::copy(m_Samples.begin(), m_Samples.begin() + m_Count, m_Sorted.begin());
+			std::sort(m_Sorted.begin(), m_Sorted.begin() + m_Count);
+
+			double sum = 0.0;
+			for (size_t i = 0; i < m_Count; i++)
+				sum += static_cast<double>(m_Sorted[i]);
+
+			//Nearest-rank percentile
+			auto percentile = [&](size_t percent) { return m_Sorted[(percent * m_Count + 99) / 100 - 1]; };
+
+			stats.Min = m_Sorted[0];
+			stats.Max = m_Sorted[m_Count - 1];
+			stats.Mean = sum / static_cast<double>(m_Count);
+			stats.P50 = percentile(50);
+			stats.P95 = percentile(95);
+			stats.P99 = percentile(99);
+			return stats;
+		}
+
+		inline void InputState::BeginFrame()
+		{
+			m_Previous = m_Current;
+
+			m_Current.PressedKeys.reset();
+			m_Current.ReleasedKeys.reset();
+			m_Current.PressedButtons = 0;
+			m_Current.ReleasedButtons = 0;
+			m_Current.WheelX = 0.0f;
+			m_Current.WheelY = 0.0f;
+		}
+
+		inline uint32_t InputState::ButtonMask(MouseButton button)
+		{
+			const uint32_t index = static_cast<uint32_t>(button);
+			return index <= static_cast<uint32_t>(MouseButton::MiddleMouseButton) ? 1u << index : 0u;
+		}
+
+		inline void InputState::ProcessEvent(const Event& event)
+		{
+			switch (event.Type)
+			{
+			case EventType::Key:
+			{
+				const size_t key = static_cast<size_t>(event.Key.Key);
+
+				//Held keys repeat their press event, only the first one counts as pressed
+				m_Current.PressedKeys[key] = m_Current.PressedKeys[key] || (event.Key.IsPressed && !m_Current.Keys[key]);
+				m_Current.ReleasedKeys[key] = m_Current.ReleasedKeys[key] || !event.Key.IsPressed;
+				m_Current.Keys[key] = event.Key.IsPressed;
+				break;
+			}
+			case EventType::MouseButton:
+			{
+				const uint32_t mask = ButtonMask(event.Button.Button);
+
+				if (event.Button.IsPressed)
+				{
+					m_Current.PressedButtons |= mask & ~m_Current.Buttons;
+					m_Current.Buttons |= mask;
+				}
+				else
+				{
+					m_Current.ReleasedButtons |= mask;
+					m_Current.Buttons &= ~mask;
+				}
+				break;
+			}
+			case EventType::MouseMove:
+				m_Current.MouseX = event.Motion.X;
+				m_Current.MouseY = event.Motion.Y;
+				break;
+			case EventType::MouseScroll:
+				m_Current.WheelX += event.Scroll.X;
+				m_Current.WheelY += event.Scroll.Y;
+				break;
+			default:
+				break;
+			}
+		}
+
+		inline NativeWindowPtr NativeWindow::Create(Window* window)
+		{
+			if (window->GetWindowDescription().Headless)
+			{
+				return std::make_shared<HeadlessNativeWindow>(window);
+			}
+
+#if defined(_WIN32)
+			return std::make_shared<Win32NativeWindow>(window);
+#elif defined(__linux__)
+			return std::make_shared<X11NativeWindow>(window);
+#else
+			throw Error("Swindow does not support this platform");
+#endif
+		}
+
+		inline void NativeWindow::DispatchEvent(const Event& event)
+		{
+			if (m_EventThreadQueue)
+			{
+				//Input is never dropped: if the render thread falls behind, wait for it to make room
+				while (!m_EventThreadQueue->Push(event) && m_EventThreadRunning.load(std::memory_order_relaxed))
+				{
+					std::this_thread::yield();
+				}
+
+				//Only pay for the lock when the render thread is actually sleeping in WaitEvents.
+				//The fence pairs with the one in WaitEvents: without it the push and the m_IsWaiting load can be
+				//reordered, and both threads miss each other's store.
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (m_IsWaiting.load(std::memory_order_relaxed))
+				{
+					std::lock_guard<std::mutex> lock(m_WakeMutex);
+					m_WakeCondition.notify_one();
+				}
+				return;
+			}
+
+			m_Window->DispatchEvent(event);
+		}
+
+		inline void NativeWindow::ProcessEvents()
+		{
+			if (m_EventThreadQueue)
+			{
+				Event event;
+				while (m_EventThreadQueue->Pop(event))
+				{
+					m_Window->DispatchEvent(event);
+				}
+				return;
+			}
+
+			PollEvents();
+		}
+
+		inline void NativeWindow::WaitEvents(double timeout)
+		{
+			if (!m_EventThreadQueue)
+			{
+				WaitForEvents(timeout);
+				return;
+			}
+
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
+
+			//Set before checking the queue, so an event pushed in between is guaranteed to notify.
+			//The fence keeps the queue check from being performed before the store is visible.
+			m_IsWaiting.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			const auto isReady = [this]() { return m_WakeRequested || !m_EventThreadQueue->IsEmpty(); };
+			if (timeout < 0.0)
+			{
+				m_WakeCondition.wait(lock, isReady);
+			}
+			else
+			{
+				m_WakeCondition.wait_for(lock, std::chrono::duration<double>(timeout), isReady);
+			}
+
+			m_IsWaiting = false;
+			m_WakeRequested = false;
+		}
+
+		inline void NativeWindow::PostEmptyEvent()
+		{
+			if (!m_EventThreadQueue)
+			{
+				WakeUp();
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_WakeRequested = true;
+			m_WakeCondition.notify_one();
+		}
+
+		inline void NativeWindow::StartEventThread()
+		{
+			if (IsEventThreadRunning())
+				return;
+
+			m_EventThreadQueue.reset(new EventThreadQueue());
+			m_EventThreadRunning = true;
+
+			std::promise<void> started;
+			std::future<void> startedFuture = started.get_future();
+
+			m_EventThread = std::thread([this, &started]()
+				{
+					try
+					{
+						OnEventThreadStart();
+						started.set_value();
+					}
+					catch (...)
+					{
+						started.set_exception(std::current_exception());
+						return;
+					}
+
+					while (m_EventThreadRunning.load(std::memory_order_acquire))
+					{
+						PollEvents();
+
+						//StopEventThread calls WakeUp, so the thread can sleep until the OS has something for it
+						WaitForEvents(-1.0);
+					}
+
+					OnEventThreadStop();
+				});
+
+			try
+			{
+				startedFuture.get();
+			}
+			catch (...)
+			{
+				m_EventThreadRunning = false;
+				m_EventThread.join();
+				m_EventThreadQueue.reset();
+				throw;
+			}
+		}
+
+		inline void NativeWindow::StopEventThread()
+		{
+			if (!IsEventThreadRunning())
+				return;
+
+			m_EventThreadRunning = false;
+			WakeUp();
+
+			m_EventThread.join();
+			m_EventThreadQueue.reset();
+		}
+
+#pragma region Render
+
+		inline void RenderContext::SetViewportSize(int width, int height)
+		{
+			SW_PROFILE_SCOPE("RenderContext::SetViewportSize");
+			glViewport(0, 0, width, height);
+		}
+
+		inline void RenderContext::Clear()
+		{
+			SW_PROFILE_SCOPE("RenderContext::Clear");
+
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			glClearColor(0.0f, 0.0f, 0.0f, 1);
+		}
+
+		inline void RenderContext::DrawQuad(float x, float y, float scale, Colour colour)
+		{
+			SW_PROFILE_SCOPE("RenderContext::DrawQuad");
+			BatchData& batch = GetBatchData();
+			if (batch.IsActive)
+			{
+				batch.Instances.push_back({ x, y, scale, colour.R, colour.G, colour.B, colour.A });
+				return;
+			}
+
+			//Outside of a batch, draw immediately with the legacy fixed-function pipeline
+			// Enable blending for transparency
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			// Set up the translation and scaling transformations
+			glPushMatrix();  // Save the current transformation matrix
+
+			glTranslatef(x, y, 0.0f);  // Translate the quad to position (x, y)
+			glScalef(scale, scale, 1.0f);  // Scale the quad by 'scale'
+
+			// Set the color with an alpha value for transparency
+			glColor4f(colour.R, colour.G, colour.B, colour.A);  // Red color with 25% opacity
+
+			// Draw the quad
+			glBegin(GL_QUADS);
+			glVertex3f(-1.0f, -1.0f, 0.0f); // Bottom left
+			glVertex3f(1.0f, -1.0f, 0.0f);  // Bottom right
+			glVertex3f(1.0f, 1.0f, 0.0f);   // Top right
+			glVertex3f(-1.0f, 1.0f, 0.0f);  // Top left
+			glEnd();
+
+			// Restore the previous transformation matrix
+			glPopMatrix();
+
+			// Disable blending if it's not needed for other objects
+			glDisable(GL_BLEND);
+		}
+
+		inline void RenderContext::BeginBatch()
+		{
+			SW_PROFILE_SCOPE("RenderContext::BeginBatch");
+			BatchData& batch = GetBatchData();
+			batch.Instances.clear();
+			batch.IsActive = true;
+		}
+
+		inline void RenderContext::Flush()
+		{
+			SW_PROFILE_SCOPE("RenderContext::Flush");
+			BatchData& batch = GetBatchData();
+			batch.IsActive = false;
+
+			if (batch.Instances.empty())
+				return;
+
+			if (batch.IsUnsupported || (!batch.Program && !InitBatch(batch)))
+			{
+				//Only tried once per context, then every Flush draws the quads with the immediate path
+				batch.IsUnsupported = true;
+				for (const QuadInstance& quad : batch.Instances)
+				{
+					DrawQuad(quad.X, quad.Y, quad.Scale, { quad.R, quad.G, quad.B, quad.A });
+				}
+				batch.Instances.clear();
+				return;
+			}
+
+			const GLFunctions& gl = GetGLFunctions();
+			const size_t count = batch.Instances.size();
+
+			gl.BindBuffer(GL_ARRAY_BUFFER, batch.InstanceBuffer);
+
+			if (count > batch.BufferCapacity)
+			{
+				//Grow geometrically so a steadily increasing quad count does not reallocate every frame
+				while (batch.BufferCapacity < count)
+				{
+					batch.BufferCapacity = batch.BufferCapacity ? batch.BufferCapacity * 2 : 1024;
+				}
+			}
+
+			//Orphan the previous storage so the driver never has to wait for the last frame's draw to finish
+			gl.BufferData(GL_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(batch.BufferCapacity * sizeof(QuadInstance)), nullptr, GL_STREAM_DRAW);
+			gl.BufferSubData(GL_ARRAY_BUFFER, 0, static_cast<std::ptrdiff_t>(count * sizeof(QuadInstance)), batch.Instances.data());
+
+			glEnable(GL_BLEND);
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+			gl.UseProgram(batch.Program);
+			gl.BindVertexArray(batch.VertexArray);
+			gl.DrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+			gl.BindVertexArray(0);
+			gl.UseProgram(0);
+
+			glDisable(GL_BLEND);
+
+			batch.Instances.clear();
+		}
+
+		inline void RenderContext::SetCurrentContext(const void* context)
+		{
+			//unordered_map never moves its elements, so the pointer stays valid until the context shuts down
+			GetCurrentBatch() = &GetBatches()[context];
+		}
+
+		inline void RenderContext::Shutdown(const void* context)
+		{
+			auto& batches = GetBatches();
+			auto found = batches.find(context);
+			if (found == batches.end())
+				return;
+
+			BatchData& batch = found->second;
+			if (batch.Program)
+			{
+				const GLFunctions& gl = GetGLFunctions();
+				gl.DeleteBuffers(1, &batch.InstanceBuffer);
+				gl.DeleteVertexArrays(1, &batch.VertexArray);
+				gl.DeleteProgram(batch.Program);
+			}
+
+			if (GetCurrentBatch() == &batch)
+			{
+				GetCurrentBatch() = nullptr;
+			}
+
+			batches.erase(found);
+		}
+
+		inline RenderContext::BatchData& RenderContext::GetBatchData()
+		{
+			BatchData*& current = GetCurrentBatch();
+			if (!current)
+			{
+				//Contexts made current outside of Swindow share one batch
+				current = &GetBatches()[nullptr];
+			}
+
+			return *current;
+		}
+
+		inline std::unordered_map<const void*, RenderContext::BatchData>& RenderContext::GetBatches()
+		{
+			static std::unordered_map<const void*, BatchData> batches;
+			return batches;
+		}
+
+		inline RenderContext::BatchData*& RenderContext::GetCurrentBatch()
+		{
+			static thread_local BatchData* current = nullptr;
+			return current;
+		}
+
+		inline bool RenderContext::InitBatch(BatchData& batch)
+		{
+			const GLFunctions& gl = GetGLFunctions();
+			if (!gl.DrawArraysInstanced || !gl.VertexAttribDivisor || !gl.CreateProgram)
+			{
+				SW_LOG_WARNING("Batch rendering requires an OpenGL 3.3 context, drawing quads immediately instead");
+				return false;
+			}
+
+			//The quad corners are generated from gl_VertexID, so the only vertex data is one instance per quad
+			const char* vertexSource = R"(#version 330 core
+layout(location = 0) in vec3 a_Transform;
+layout(location = 1) in vec4 a_Colour;
+out vec4 v_Colour;
+const vec2 c_Corners[4] = vec2[4](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+void main()
+{
+	gl_Position = vec4(a_Transform.xy + c_Corners[gl_VertexID] * a_Transform.z, 0.0, 1.0);
+	v_Colour = a_Colour;
+})";
+
+			const char* fragmentSource = R"(#version 330 core
+in vec4 v_Colour;
+out vec4 o_Colour;
+void main()
+{
+	o_Colour = v_Colour;
+})";
+
+			const GLuint shaders[2] = { gl.CreateShader(GL_VERTEX_SHADER), gl.CreateShader(GL_FRAGMENT_SHADER) };
+			const char* sources[2] = { vertexSource, fragmentSource };
+
+			GLuint program = gl.CreateProgram();
+			for (int i = 0; i < 2; ++i)
+			{
+				gl.ShaderSource(shaders[i], 1, &sources[i], nullptr);
+				gl.CompileShader(shaders[i]);
+
+				GLint compiled = 0;
+				gl.GetShaderiv(shaders[i], GL_COMPILE_STATUS, &compiled);
+				if (!compiled)
+				{
+					char log[512];
+					gl.GetShaderInfoLog(shaders[i], sizeof(log), nullptr, log);
+					SW_LOG_ERROR("Batch shader compilation failed: %s", log);
+				}
+
+				gl.AttachShader(program, shaders[i]);
+			}
+
+			gl.LinkProgram(program);
+			gl.DeleteShader(shaders[0]);
+			gl.DeleteShader(shaders[1]);
+
+			GLint linked = 0;
+			gl.GetProgramiv(program, GL_LINK_STATUS, &linked);
+			if (!linked)
+			{
+				char log[512];
+				gl.GetProgramInfoLog(program, sizeof(log), nullptr, log);
+				SW_LOG_ERROR("Batch shader linking failed: %s", log);
+				gl.DeleteProgram(program);
+				return false;
+			}
+
+			gl.GenVertexArrays(1, &batch.VertexArray);
+			gl.GenBuffers(1, &batch.InstanceBuffer);
+
+			gl.BindVertexArray(batch.VertexArray);
+			gl.BindBuffer(GL_ARRAY_BUFFER, batch.InstanceBuffer);
+
+			//Position and scale
+			gl.EnableVertexAttribArray(0);
+			gl.VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), reinterpret_cast<const void*>(offsetof(QuadInstance, X)));
+			gl.VertexAttribDivisor(0, 1);
+
+			//Colour
+			gl.EnableVertexAttribArray(1);
+			gl.VertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), reinterpret_cast<const void*>(offsetof(QuadInstance, R)));
+			gl.VertexAttribDivisor(1, 1);
+
+			gl.BindVertexArray(0);
+
+			batch.Program = program;
+			return true;
+		}
+
+		inline bool GLFunctions::Load(const Window& window)
+		{
+			bool loadedAll = true;
+
+#define SW_GL_LOAD(returnType, name, params) \
+			name = reinterpret_cast<returnType (SW_APIENTRY*) params>(window.GetProcAddress("gl" #name)); \
+			loadedAll &= (name != nullptr);
+
+			SW_GL_FUNCTIONS(SW_GL_LOAD)
+#undef SW_GL_LOAD
+
+			Complete = loadedAll;
+			return loadedAll;
+		}
+
+		//Tables never move once created, so pointers handed out stay valid
+		struct GLFunctionCache
+		{
+			std::mutex Mutex;
+			std::unordered_map<std::string, std::unique_ptr<GLFunctions>> Tables;
+			std::atomic<const GLFunctions*> Latest{ nullptr };
+		};
+
+		inline GLFunctionCache& GetGLFunctionCache()
+		{
+			static GLFunctionCache cache;
+			return cache;
+		}
+
+		inline const GLFunctions& AcquireGLFunctions(const Window& window)
+		{
+			//Function pointers depend on the loader and the driver behind the context, not on the context itself
+			auto getString = [](GLenum name)
+				{
+					const GLubyte* value = glGetString(name);
+					return value ? reinterpret_cast<const char*>(value) : "";
+				};
+
+			const WindowDescription& description = window.GetWindowDescription();
+			std::string key = description.Headless ? "Headless|" : (description.UseEGL ? "EGL|" : "Native|");
+			key += getString(GL_VENDOR);
+			key += '|';
+			key += getString(GL_RENDERER);
+			key += '|';
+			key += getString(GL_VERSION);
+
+			GLFunctionCache& cache = GetGLFunctionCache();
+			std::lock_guard<std::mutex> lock(cache.Mutex);
+
+			std::unique_ptr<GLFunctions>& table = cache.Tables[key];
+			if (!table)
+			{
+				table.reset(new GLFunctions());
+				table->Load(window);
+			}
+
+			cache.Latest = table.get();
+			return *table;
+		}
+
+		inline const GLFunctions*& GetThreadGLFunctions()
+		{
+			static thread_local const GLFunctions* current = nullptr;
+			return current;
+		}
+
+		inline void SetCurrentGLFunctions(const GLFunctions* functions)
+		{
+			GetThreadGLFunctions() = functions;
+		}
+
+		inline const GLFunctions& GetGLFunctions()
+		{
+			const GLFunctions* current = GetThreadGLFunctions();
+			if (current)
+				return *current;
+
+			const GLFunctions* latest = GetGLFunctionCache().Latest;
+			if (latest)
+				return *latest;
+
+			static const GLFunctions empty;
+			return empty;
+		}
+
+		inline GLLibrary::GLLibrary()
+		{
+#ifdef _WIN32
+			m_Module = LoadLibraryA("opengl32.dll");
+#else
+			//libOpenGL is the vendor neutral library exporting core functions for EGL contexts,
+			//libGL exports them for GLX. Both are usually loaded already, so this only takes a reference.
+			const char* libraries[] = { "libGL.so.1", "libOpenGL.so.0", "libGL.so" };
+			for (const char* library : libraries)
+			{
+				m_Module = dlopen(library, RTLD_LAZY | RTLD_LOCAL);
+				if (m_Module)
+					break;
+			}
+#endif
+		}
+
+		inline GLLibrary::~GLLibrary()
+		{
+			if (!m_Module)
+				return;
+
+#ifdef _WIN32
+			FreeLibrary(m_Module);
+#else
+			dlclose(m_Module);
+#endif
+		}
+
+		inline GLLibrary& GLLibrary::Get()
+		{
+			static GLLibrary library;
+			return library;
+		}
+
+		inline void* GLLibrary::GetSymbol(const char* name)
+		{
+			GLLibrary& library = Get();
+			if (!library.m_Module)
+				return nullptr;
+
+#ifdef _WIN32
+			return (void*)::GetProcAddress(library.m_Module, name);
+#else
+			return dlsym(library.m_Module, name);
+#endif
+		}
+
+		inline void FrameCapture::Update(int width, int height, uint64_t frameIndex)
+		{
+			if (m_Count > 0)
+			{
+				Deliver(false);
+			}
+
+			if (!m_Requested)
+				return;
+
+			m_Requested = false;
+			SW_PROFILE_SCOPE("FrameCapture::Update");
+
+			const GLFunctions& gl = GetGLFunctions();
+			if (!gl.FenceSync || !gl.MapBufferRange)
+			{
+				SW_LOG_ERROR("Frame capture requires an OpenGL 3.2 context");
+				m_Dropped++;
+				return;
+			}
+
+			//The ring only changes size while it is empty, so captures in flight keep their order
+			if (m_Count == 0 && m_Slots.size() != m_RingSize)
+			{
+				Shutdown();
+				m_Slots.resize(m_RingSize);
+				m_Head = 0;
+			}
+
+			if (m_Count == m_Slots.size() || width <= 0 || height <= 0)
+			{
+				m_Dropped++;
+				return;
+			}
+
+			Slot& slot = m_Slots[(m_Head + m_Count) % m_Slots.size()];
+			const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+
+			if (!slot.Buffer)
+			{
+				gl.GenBuffers(1, &slot.Buffer);
+			}
+
+			gl.BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+			if (slot.Capacity < size)
+			{
+				gl.BufferData(GL_PIXEL_PACK_BUFFER, static_cast<std::ptrdiff_t>(size), nullptr, GL_STREAM_READ);
+				slot.Capacity = size;
+			}
+
+			//With a pack buffer bound the read only queues a copy on the GPU and returns immediately
+			glPixelStorei(GL_PACK_ALIGNMENT, 4);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+			slot.Fence = gl.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			slot.Width = width;
+			slot.Height = height;
+			slot.FrameIndex = frameIndex;
+			m_Count++;
+		}
+
+		inline void FrameCapture::Flush()
+		{
+			Deliver(true);
+		}
+
+		inline void FrameCapture::Deliver(bool wait)
+		{
+			const GLFunctions& gl = GetGLFunctions();
+
+			while (m_Count > 0)
+			{
+				Slot& slot = m_Slots[m_Head];
+
+				//A zero timeout only polls the fence; waiting flushes so the fence is guaranteed to be reached
+				const GLbitfield flags = wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0;
+				const uint64_t timeout = wait ? ~0ull : 0;
+				const GLenum status = gl.ClientWaitSync(slot.Fence, flags, timeout);
+				if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				{
+					if (!wait)
+						return;
+
+					//The fence failed, e.g. because the context was lost. Give the capture up rather than spin.
+					m_Dropped++;
+				}
+				else
+				{
+					gl.BindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer);
+					const size_t size = static_cast<size_t>(slot.Width) * static_cast<size_t>(slot.Height) * 4;
+					const void* pixels = gl.MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<std::ptrdiff_t>(size), GL_MAP_READ_BIT);
+
+					if (pixels && m_Callback)
+					{
+						CapturedFrame frame;
+						frame.Pixels = static_cast<const uint8_t*>(pixels);
+						frame.Width = slot.Width;
+						frame.Height = slot.Height;
+						frame.FrameIndex = slot.FrameIndex;
+						frame.Timestamp = Window::GetTime();
+						m_Callback(frame);
+					}
+
+					if (pixels)
+					{
+						gl.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+					}
+					gl.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+				}
+
+				gl.DeleteSync(slot.Fence);
+				slot.Fence = nullptr;
+				m_Head = (m_Head + 1) % m_Slots.size();
+				m_Count--;
+			}
+		}
+
+		inline void FrameCapture::Shutdown()
+		{
+			if (m_Slots.empty())
+				return;
+
+			const GLFunctions& gl = GetGLFunctions();
+			for (Slot& slot : m_Slots)
+			{
+				if (slot.Fence)
+				{
+					gl.DeleteSync(slot.Fence);
+				}
+
+				if (slot.Buffer)
+				{
+					gl.DeleteBuffers(1, &slot.Buffer);
+				}
+
+				slot = Slot();
+			}
+
+			m_Slots.clear();
+			m_Head = 0;
+			m_Count = 0;
+		}
+
+
+#pragma endregion
+
+
+#ifdef _WIN32
+
+		//OpenGL
+
+		typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
+
+		// These values come from the OpenGL and WGL extension specifications
+
+#define WGL_CONTEXT_MAJOR_VERSION_ARB 0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB 0x2092
+#define WGL_CONTEXT_LAYER_PLANE_ARB   0x2093
+#define WGL_CONTEXT_FLAGS_ARB         0x2094
+#define WGL_CONTEXT_PROFILE_MASK_ARB  0x9126
+
+// Values for WGL_CONTEXT_FLAGS_ARB
+#define WGL_CONTEXT_DEBUG_BIT_ARB              0x0001
+#define WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB 0x0002
+
+// Values for WGL_CONTEXT_PROFILE_MASK_ARB
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB		  0x0001
+#define WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x0002
+
+
+		inline Win32NativeWindow::Win32NativeWindow(Window* window)
+		{
+			m_Window = window;
+
+			m_Instance = GetModuleHandle(nullptr);
+
+			RegisterWindowClass(m_Instance);
+
+			//With an event thread the window is created by that thread, see OnEventThreadStart
+			if (!m_Window->GetWindowDescription().EventThread)
+			{
+				CreateNativeWindow();
+			}
+		}
+
+		inline void Win32NativeWindow::CreateNativeWindow()
+		{
+			//Defines the window size
+			RECT rect = { 0, 0, m_Window->GetWindowDescription().Width, m_Window->GetWindowDescription().Height };
+			AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
+
+			//Create a temp title to avoid assertion
+			const auto title = m_Window->GetWindowDescription().Title;
+			const std::wstring wtitle(title.begin(), title.end());
+
+
+			//Creates the main application window
+			m_WindowHandle = CreateWindowEx(
+				0, L"SwindowWindowClass",
+				wtitle.c_str(),
+				WS_OVERLAPPEDWINDOW,
+				CW_USEDEFAULT, CW_USEDEFAULT, rect.right - rect.left, rect.bottom - rect.top,
+				nullptr, nullptr, m_Instance, m_Window
+			);
+
+			if (!m_WindowHandle)
+			{
+				DWORD error = GetLastError();
+				wchar_t errorMsg[256];
+				FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, error, 0, errorMsg, 256, nullptr);
+				MessageBox(nullptr, errorMsg, L"CreateWindowEx Failed", MB_ICONERROR | MB_OK);
+
+				return;
+			}
+
+			//Pass the window pointer to the WindowProc function
+			SetWindowLongPtr(m_WindowHandle, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+			m_DeviceContext = GetDC(m_WindowHandle);
+
+			ShowWindow(m_WindowHandle, SW_SHOW);
+			UpdateWindow(m_WindowHandle);
+		}
+
+		inline void Win32NativeWindow::DestroyNativeWindow()
+		{
+			ReleaseDC(m_WindowHandle, m_DeviceContext);
+			DestroyWindow(m_WindowHandle);
+		}
+
+		inline void Win32NativeWindow::Destroy()
+		{
+			wglMakeCurrent(nullptr, nullptr);
+			wglDeleteContext(m_OpenGLContext);
+			m_OpenGLContext = nullptr;
+
+			//The device context and window belong to the thread that created them
+			if (IsEventThreadRunning())
+			{
+				StopEventThread();
+			}
+			else
+			{
+				DestroyNativeWindow();
+			}
+
+			UnregisterWindowClass(m_Instance);
+		}
+
+		inline void Win32NativeWindow::MakeContextCurrent()
+		{
+			if (m_OpenGLContext)
+			{
+				wglMakeCurrent(m_DeviceContext, m_OpenGLContext);
+			}
+		}
+
+		inline void Win32NativeWindow::OnEventThreadStart()
+		{
+			CreateNativeWindow();
+		}
+
+		inline void Win32NativeWindow::OnEventThreadStop()
+		{
+			DestroyNativeWindow();
+		}
+
+		inline void Win32NativeWindow::WaitForEvents(double timeout)
+		{
+			const DWORD milliseconds = timeout < 0.0 ? INFINITE : static_cast<DWORD>(timeout * 1000.0);
+			MsgWaitForMultipleObjectsEx(0, nullptr, milliseconds, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		}
+
+		inline void Win32NativeWindow::WakeUp()
+		{
+			PostMessage(m_WindowHandle, WM_NULL, 0, 0);
+		}
+
+		inline void Win32NativeWindow::PollEvents()
+		{
+			MSG msg;
+			while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+			{
+				TranslateMessage(&msg);
+				DispatchMessage(&msg);
+			}
+		}
+
+		inline void Win32NativeWindow::RefreshScreen()
+		{
+			SwapBuffers(m_DeviceContext);
+		}
+
+		//Virtual key code to KeyCode, indexed by the WM_KEYDOWN/WM_KEYUP wParam
+		inline constexpr KeyTable MakeWin32KeyTable()
+		{
+			KeyTable table = {};
+
+			table.MapRange('A', 26, KeyCode::A);
+			table.MapRange('0', 10, KeyCode::Num0);
+
+			table.Keys[VK_ESCAPE] = KeyCode::Escape;	table.Keys[VK_RETURN] = KeyCode::Enter;
+			table.Keys[VK_SPACE] = KeyCode::Space;		table.Keys[VK_BACK] = KeyCode::Backspace;
+			table.Keys[VK_TAB] = KeyCode::Tab;
+
+			table.Keys[VK_SHIFT] = KeyCode::Shift;		table.Keys[VK_LSHIFT] = KeyCode::Shift;		table.Keys[VK_RSHIFT] = KeyCode::Shift;
+			table.Keys[VK_CONTROL] = KeyCode::Ctrl;		table.Keys[VK_LCONTROL] = KeyCode::Ctrl;	table.Keys[VK_RCONTROL] = KeyCode::Ctrl;
+			table.Keys[VK_MENU] = KeyCode::Alt;			table.Keys[VK_LMENU] = KeyCode::Alt;		table.Keys[VK_RMENU] = KeyCode::Alt;
+			table.Keys[VK_LWIN] = KeyCode::Super;		table.Keys[VK_RWIN] = KeyCode::Super;		table.Keys[VK_APPS] = KeyCode::Menu;
+
+			table.Keys[VK_LEFT] = KeyCode::Left;		table.Keys[VK_RIGHT] = KeyCode::Right;
+			table.Keys[VK_UP] = KeyCode::Up;			table.Keys[VK_DOWN] = KeyCode::Down;
+
+			table.MapRange(VK_F1, 12, KeyCode::F1);
+			table.MapRange(VK_F13, 12, KeyCode::F13);
+
+			table.Keys[VK_OEM_3] = KeyCode::Grave;			table.Keys[VK_OEM_MINUS] = KeyCode::Minus;
+			table.Keys[VK_OEM_PLUS] = KeyCode::Equal;		table.Keys[VK_OEM_4] = KeyCode::LeftBracket;
+			table.Keys[VK_OEM_6] = KeyCode::RightBracket;	table.Keys[VK_OEM_5] = KeyCode::Backslash;
+			table.Keys[VK_OEM_1] = KeyCode::Semicolon;		table.Keys[VK_OEM_7] = KeyCode::Apostrophe;
+			table.Keys[VK_OEM_COMMA] = KeyCode::Comma;		table.Keys[VK_OEM_PERIOD] = KeyCode::Period;
+			table.Keys[VK_OEM_2] = KeyCode::Slash;
+
+			table.Keys[VK_CAPITAL] = KeyCode::CapsLock;		table.Keys[VK_SCROLL] = KeyCode::ScrollLock;
+			table.Keys[VK_NUMLOCK] = KeyCode::NumLock;		table.Keys[VK_SNAPSHOT] = KeyCode::PrintScreen;
+			table.Keys[VK_PAUSE] = KeyCode::Pause;			table.Keys[VK_INSERT] = KeyCode::Insert;
+			table.Keys[VK_DELETE] = KeyCode::Delete;		table.Keys[VK_HOME] = KeyCode::Home;
+			table.Keys[VK_END] = KeyCode::End;				table.Keys[VK_PRIOR] = KeyCode::PageUp;
+			table.Keys[VK_NEXT] = KeyCode::PageDown;
+
+			table.MapRange(VK_NUMPAD0, 10, KeyCode::Keypad0);
+			table.Keys[VK_DECIMAL] = KeyCode::KeypadDecimal;	table.Keys[VK_DIVIDE] = KeyCode::KeypadDivide;
+			table.Keys[VK_MULTIPLY] = KeyCode::KeypadMultiply;	table.Keys[VK_SUBTRACT] = KeyCode::KeypadSubtract;
+			table.Keys[VK_ADD] = KeyCode::KeypadAdd;
+
+			return table;
+		}
+
+		inline KeyCode Win32NativeWindow::TranslateKey(int key)
+		{
+			static constexpr KeyTable keyTable = MakeWin32KeyTable();
+
+			return (key >= 0 && key < 256) ? keyTable.Keys[key] : KeyCode::Unknown;
+		}
+
+		inline void Win32NativeWindow::CreateContext(int major, int minor, bool legacy, void* shareContext)
+		{
+			constexpr PIXELFORMATDESCRIPTOR formatDescriptor =
+			{
+				sizeof(PIXELFORMATDESCRIPTOR),													// Size of the descriptor
+				1,																				// Version number
+				PFD_DRAW_TO_WINDOW |															// Support window drawing
+				PFD_SUPPORT_OPENGL |															// Support OpenGL
+				PFD_DOUBLEBUFFER,																// Enable double buffering
+				PFD_TYPE_RGBA,																	// RGBA color mode
+				32,																				// 32-bit color depth
+				0, 0, 0, 0, 0, 0,              // Ignore color bits
+				0,																				// No alpha buffer
+				0,																				// Ignore shift bit
+				0,																				// No accumulation buffer
+				0, 0, 0, 0,								// Ignore accumulation bits
+				24,																				// 24-bit z-buffer
+				8,																				// 8-bit stencil buffer
+				0,																				// No auxiliary buffer
+				PFD_MAIN_PLANE,																	// Main drawing layer
+				0,																				// Reserved
+		0, 0, 0															// Layer masks ignored
+			};
+
+			const int format = ChoosePixelFormat(m_DeviceContext, &formatDescriptor);
+			SetPixelFormat(m_DeviceContext, format, &formatDescriptor);
+
+			//Create a dummy context to load extensions
+			HGLRC tempContext = wglCreateContext(m_DeviceContext);
+			wglMakeCurrent(m_DeviceContext, tempContext);
+
+			//Load wglCreateContextAttrribsARB, kept for worker contexts
+			m_CreateContextAttribs = (PFNWGLCREATECONTEXTATTRIBSARBPROC)GetExternalAddress("wglCreateContextAttribsARB");
+
+			if (!m_CreateContextAttribs)
+			{
+				DWORD error = GetLastError();
+				wchar_t errorMsg[256];
+				int result = swprintf(errorMsg, sizeof(errorMsg), L"Error Code: %lu", error);
+				MessageBox(nullptr, errorMsg, L"Context Creation Failed", MB_ICONERROR);
+				return;
+			}
+
+			HGLRC glContext = CreateWGLContext(major, minor, legacy, static_cast<HGLRC>(shareContext));
+
+			if (!glContext)
+			{
+				MessageBox(nullptr, L"There was an error creating the OpenGL context", L"Error Creating Context", MB_ICONERROR);
+				wglMakeCurrent(nullptr, nullptr);
+				wglDeleteContext(tempContext);
+				return;
+			}
+
+			//Delete the dummy context
+			wglMakeCurrent(nullptr, nullptr);
+			wglDeleteContext(tempContext);
+
+			wglMakeCurrent(m_DeviceContext, glContext);
+			m_OpenGLContext = glContext;
+			m_ContextVersion = { major, minor, legacy };
+
+			//Query swap control support
+			typedef const char* (WINAPI* PFNWGLGETEXTENSIONSSTRINGARBPROC)(HDC);
+			PFNWGLGETEXTENSIONSSTRINGARBPROC wglGetExtensionsStringARB =
+				(PFNWGLGETEXTENSIONSSTRINGARBPROC)GetExternalAddress("wglGetExtensionsStringARB");
+
+			const char* extensions = wglGetExtensionsStringARB ? wglGetExtensionsStringARB(m_DeviceContext) : nullptr;
+			if (HasExtension(extensions, "WGL_EXT_swap_control"))
+			{
+				m_SwapIntervalEXT = (BOOL(WINAPI*)(int))GetExternalAddress("wglSwapIntervalEXT");
+			}
+
+			m_SwapIntervalSupport.Interval = (m_SwapIntervalEXT != nullptr);
+			m_SwapIntervalSupport.Adaptive = m_SwapIntervalSupport.Interval && HasExtension(extensions, "WGL_EXT_swap_control_tear");
+		}
+
+		inline HGLRC Win32NativeWindow::CreateWGLContext(int major, int minor, bool legacy, HGLRC shareContext)
+		{
+			if (legacy)
+			{
+				//Creates OpenGL version 1.x or earlier
+				HGLRC glContext = wglCreateContext(m_DeviceContext);
+
+				//Sharing has to be set up before the new context creates any objects
+				if (glContext && shareContext)
+				{
+					wglShareLists(shareContext, glContext);
+				}
+
+				return glContext;
+			}
+
+			//Creates Modern OpenGL version
+
+			//Specify the OpenGL specifications
+			const int attribs[] =
+			{
+				WGL_CONTEXT_MAJOR_VERSION_ARB, major,
+				WGL_CONTEXT_MINOR_VERSION_ARB, minor,
+				WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+				WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
+				0,
+			};
+
+			//Create the modern OpenGL context
+			return m_CreateContextAttribs ? m_CreateContextAttribs(m_DeviceContext, shareContext, attribs) : nullptr;
+		}
+
+		inline SharedContextPtr Win32NativeWindow::CreateWorkerContext()
+		{
+			if (!m_OpenGLContext)
+				return nullptr;
+
+			HGLRC glContext = CreateWGLContext(m_ContextVersion.Major, m_ContextVersion.Minor, m_ContextVersion.Legacy, m_OpenGLContext);
+			if (!glContext)
+				return nullptr;
+
+			return SharedContextPtr(new Win32SharedContext(m_DeviceContext, glContext));
+		}
+
+		inline bool Win32NativeWindow::SetSwapInterval(int interval)
+		{
+			return m_SwapIntervalEXT && m_SwapIntervalEXT(interval);
+		}
+
+		inline void* Win32NativeWindow::GetExternalAddress(const char* name)
+		{
+			void* proc = (void*)wglGetProcAddress(name);
+
+			//Some drivers report failure with small sentinel values instead of nullptr
+			const intptr_t value = reinterpret_cast<intptr_t>(proc);
+			if (value == 0 || value == 1 || value == 2 || value == 3 || value == -1)
+			{
+				//OpenGL 1.1 functions are only exported by opengl32.dll
+				proc = GLLibrary::GetSymbol(name);
+			}
+			return proc;
+		}
+
+		inline LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+		{
+			Win32NativeWindow* windowPtr = (Win32NativeWindow*)GetWindowLongPtr(hwnd, GWLP_USERDATA);
+
+			//Return the Default if the window we get from the constructor is null. 
+			if (!windowPtr)
+			{
+				return DefWindowProc(hwnd, uMsg, wParam, lParam);
+			}
+
+			SW_PROFILE_SCOPE("WindowProc");
+
+			Event event;
+
+			//Windows message loop
+			switch (uMsg)
+			{
+			case WM_CHAR:
+				event.Type = EventType::Character;
+				event.Character.Character = static_cast<char>(wParam);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_SIZE:
+				//Window Resize Event
+				event.Type = EventType::Resize;
+				event.Size.Width = LOWORD(lParam);
+				event.Size.Height = HIWORD(lParam);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_KEYDOWN:
+			case WM_KEYUP:
+				event.Type = EventType::Key;
+				event.Key.Key = windowPtr->ConvertNativeKeyCodes(static_cast<int>(wParam));
+				event.Key.IsPressed = (uMsg == WM_KEYDOWN);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_LBUTTONDOWN:
+			case WM_LBUTTONUP:
+				event.Type = EventType::MouseButton;
+				event.Button.Button = MouseButton::LeftMouseButton;
+				event.Button.IsPressed = (uMsg == WM_LBUTTONDOWN);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_RBUTTONDOWN:
+			case WM_RBUTTONUP:
+				event.Type = EventType::MouseButton;
+				event.Button.Button = MouseButton::RightMouseButton;
+				event.Button.IsPressed = (uMsg == WM_RBUTTONDOWN);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_MBUTTONDOWN:
+			case WM_MBUTTONUP:
+				event.Type = EventType::MouseButton;
+				event.Button.Button = MouseButton::MiddleMouseButton;
+				event.Button.IsPressed = (uMsg == WM_MBUTTONDOWN);
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_MOUSEWHEEL:
+			case WM_MOUSEHWHEEL:
+			{
+				const float notches = static_cast<float>(GET_WHEEL_DELTA_WPARAM(wParam)) / WHEEL_DELTA;
+
+				event.Type = EventType::MouseScroll;
+				event.Scroll.X = (uMsg == WM_MOUSEHWHEEL) ? notches : 0.0f;
+				event.Scroll.Y = (uMsg == WM_MOUSEWHEEL) ? notches : 0.0f;
+				windowPtr->DispatchEvent(event);
+				return 0;
+			}
+			case WM_MOUSEMOVE:
+				event.Type = EventType::MouseMove;
+				event.Motion.X = static_cast<short>(LOWORD(lParam));
+				event.Motion.Y = static_cast<short>(HIWORD(lParam));
+				event.Motion.Time = windowPtr->ConvertEventTime(static_cast<uint32_t>(GetMessageTime()));
+				windowPtr->DispatchEvent(event);
+				break;
+			case WM_CLOSE:
+				//The close callback decides whether the window stops running, DestroyWindow is left to Window::Destroy
+				event.Type = EventType::Close;
+				windowPtr->DispatchEvent(event);
+				return 0;
+			case WM_DESTROY:
+				//Window::Destroy unregisters the window before destroying it, so only the last window ends the message loop
+				if (GetLiveWindows().empty())
+				{
+					PostQuitMessage(0);
+				}
+				return 0;
+
+			default:
+				return DefWindowProc(hwnd, uMsg, wParam, lParam);
+			}
+
+			return DefWindowProc(hwnd, uMsg, wParam, lParam);
+		}
+
+		inline void Win32NativeWindow::RegisterWindowClass(HINSTANCE hInstance)
+		{
+			//Windows with an event thread register from that thread
+			WindowClassUsers& users = GetWindowClassUsers();
+			std::lock_guard<std::mutex> lock(users.Mutex);
+			if (users.Count++ > 0) return;
+
+			WNDCLASSEX wc = {};
+			wc.cbSize = sizeof(WNDCLASSEX);
+			wc.style = CS_HREDRAW | CS_VREDRAW;
+			wc.lpfnWndProc = WindowProc;
+			wc.hInstance = hInstance;
+			wc.hIcon = LoadIcon(nullptr, IDI_APPLICATION);
+			wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
+			wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
+			wc.lpszClassName = L"SwindowWindowClass";
+			wc.hIconSm = LoadIcon(nullptr, IDI_APPLICATION);
+
+			if (!RegisterClassEx(&wc))
+			{
+				MessageBox(nullptr, L"Failed to register window class", L"Error", MB_ICONERROR | MB_OK);
+			}
+		}
+
+		inline void Win32NativeWindow::UnregisterWindowClass(HINSTANCE hInstance)
+		{
+			WindowClassUsers& users = GetWindowClassUsers();
+			std::lock_guard<std::mutex> lock(users.Mutex);
+			if (--users.Count > 0) return;
+
+			UnregisterClass(L"SwindowWindowClass", hInstance);
+		}
+
+		inline Win32NativeWindow::WindowClassUsers& Win32NativeWindow::GetWindowClassUsers()
+		{
+			static WindowClassUsers users;
+			return users;
+		}
+
+#endif
+
+#ifdef __linux__
+
+		//OpenGL
+
+		typedef GLXContext(*PFNGLXCREATECONTEXTATTRIBSARBPROC)(Display*, GLXFBConfig, GLXContext, Bool, const int*);
+
+		// These values come from the OpenGL and GLX extension specifications
+
+#ifndef GLX_CONTEXT_MAJOR_VERSION_ARB
+#define GLX_CONTEXT_MAJOR_VERSION_ARB 0x2091
+#define GLX_CONTEXT_MINOR_VERSION_ARB 0x2092
+#define GLX_CONTEXT_FLAGS_ARB         0x2094
+#define GLX_CONTEXT_PROFILE_MASK_ARB  0x9126
+
+// Values for GLX_CONTEXT_FLAGS_ARB
+#define GLX_CONTEXT_DEBUG_BIT_ARB              0x0001
+#define GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB 0x0002
+
+// Values for GLX_CONTEXT_PROFILE_MASK_ARB
+#define GLX_CONTEXT_CORE_PROFILE_BIT_ARB          0x0001
+#define GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x0002
+#endif
+
+		inline X11NativeWindow::X11NativeWindow(Window* window)
+		{
+			m_Window = window;
+			m_Width = m_Window->GetWindowDescription().Width;
+			m_Height = m_Window->GetWindowDescription().Height;
+
+			//A window with an event thread gets a connection of its own, since its events are read on that thread
+			if (m_Window->GetWindowDescription().EventThread)
+			{
+				m_Connection = std::make_shared<X11Connection>();
+			}
+			else
+			{
+				m_Connection = X11Connection::AcquireShared();
+			}
+
+			m_Display = m_Connection->GetDisplay();
+
+			const int screen = DefaultScreen(m_Display);
+			m_UseEGL = m_Window->GetWindowDescription().UseEGL;
+
+			XVisualInfo* visual = ChooseVisual(screen);
+
+			const ::Window root = RootWindow(m_Display, screen);
+			m_Colormap = XCreateColormap(m_Display, root, visual->visual, AllocNone);
+
+			XSetWindowAttributes attributes = {};
+			attributes.colormap = m_Colormap;
+			attributes.border_pixel = 0;
+			attributes.event_mask = KeyPressMask | KeyReleaseMask |
+				ButtonPressMask | ButtonReleaseMask | PointerMotionMask |
+				StructureNotifyMask | ExposureMask;
+
+			//Creates the main application window
+			m_WindowHandle = XCreateWindow(
+				m_Display, root,
+				0, 0, m_Width, m_Height,
+				0, visual->depth, InputOutput, visual->visual,
+				CWColormap | CWBorderPixel | CWEventMask, &attributes
+			);
+
+			XFree(visual);
+
+			if (!m_WindowHandle)
+			{
+				XFreeColormap(m_Display, m_Colormap);
+				m_EGL.Destroy();
+				throw Error("XCreateWindow Failed");
+			}
+
+			m_Connection->Register(m_WindowHandle, this);
+
+			XStoreName(m_Display, m_WindowHandle, m_Window->GetWindowDescription().Title.c_str());
+
+			//Ask the window manager to send a ClientMessage instead of killing the connection when the window is closed
+			m_DeleteWindowAtom = XInternAtom(m_Display, "WM_DELETE_WINDOW", False);
+			XSetWMProtocols(m_Display, m_WindowHandle, &m_DeleteWindowAtom, 1);
+
+			//Report held keys as repeated KeyPress events only, matching WM_KEYDOWN on Win32
+			XkbSetDetectableAutoRepeat(m_Display, True, nullptr);
+
+			m_WakeEvent = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+			XMapWindow(m_Display, m_WindowHandle);
+			XFlush(m_Display);
+		}
+
+		inline XVisualInfo* X11NativeWindow::ChooseVisual(int screen)
+		{
+			//The window visual has to match the config used by the context,
+			//so the config is chosen up front and reused in CreateContext.
+			if (m_UseEGL)
+			{
+				if (!m_EGL.Initialize(EGL_PLATFORM_X11_EXT, m_Display))
+				{
+					throw Error("Failed to initialize an EGL display for the X11 window");
+				}
+
+				if (!m_EGL.ChooseConfig(EGL_WINDOW_BIT))
+				{
+					m_EGL.Destroy();
+					throw Error("Failed to find a matching EGL config");
+				}
+
+				EGLint visualId = 0;
+				eglGetConfigAttrib(m_EGL.Display, m_EGL.Config, EGL_NATIVE_VISUAL_ID, &visualId);
+
+				XVisualInfo visualTemplate = {};
+				visualTemplate.visualid = static_cast<VisualID>(visualId);
+				int visualCount = 0;
+				XVisualInfo* visual = XGetVisualInfo(m_Display, VisualIDMask, &visualTemplate, &visualCount);
+				if (!visual)
+				{
+					m_EGL.Destroy();
+					throw Error("Failed to get a visual from the EGL config");
+				}
+
+				return visual;
+			}
+
+			const int frameBufferAttribs[] =
+			{
+				GLX_X_RENDERABLE, True,
+				GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+				GLX_RENDER_TYPE, GLX_RGBA_BIT,
+				GLX_X_VISUAL_TYPE, GLX_TRUE_COLOR,
+				GLX_RED_SIZE, 8,
+				GLX_GREEN_SIZE, 8,
+				GLX_BLUE_SIZE, 8,
+				GLX_ALPHA_SIZE, 8,
+				GLX_DEPTH_SIZE, 24,
+				GLX_STENCIL_SIZE, 8,
+				GLX_DOUBLEBUFFER, True,
+				None
+			};
+
+			int configCount = 0;
+			GLXFBConfig* configs = glXChooseFBConfig(m_Display, screen, frameBufferAttribs, &configCount);
+			if (!configs || configCount == 0)
+			{
+				throw Error("Failed to find a matching GLX framebuffer config");
+			}
+
+			m_FrameBufferConfig = configs[0];
+			XFree(configs);
+
+			XVisualInfo* visual = glXGetVisualFromFBConfig(m_Display, m_FrameBufferConfig);
+			if (!visual)
+			{
+				throw Error("Failed to get a visual from the GLX framebuffer config");
+			}
+
+			return visual;
+		}
+
+		inline void X11NativeWindow::Destroy()
+		{
+			if (!m_Display)
+				return;
+
+			StopEventThread();
+
+			if (m_OpenGLContext)
+			{
+				glXMakeCurrent(m_Display, None, nullptr);
+				glXDestroyContext(m_Display, m_OpenGLContext);
+				m_OpenGLContext = nullptr;
+			}
+
+			//The EGL surface has to go before the window it was created for
+			m_EGL.Destroy();
+
+			m_Connection->Unregister(m_WindowHandle);
+			XDestroyWindow(m_Display, m_WindowHandle);
+			XFreeColormap(m_Display, m_Colormap);
+			XFlush(m_Display);
+
+			//Closes the display if this was the last window on it
+			m_Connection = nullptr;
+			m_Display = nullptr;
+
+			close(m_WakeEvent);
+			m_WakeEvent = -1;
+		}
+
+		inline X11Connection::X11Connection()
+		{
+			//Event threads and worker contexts use the connection from other threads. XInitThreads has to run before any
+			//other Xlib call; it only has an effect the first time and is the default since libX11 1.8.
+			XInitThreads();
+
+			m_Display = XOpenDisplay(nullptr);
+			if (!m_Display)
+			{
+				throw Error("Failed to open the X display. Is DISPLAY set?");
+			}
+		}
+
+		inline X11Connection::~X11Connection()
+		{
+			XCloseDisplay(m_Display);
+		}
+
+		inline std::shared_ptr<X11Connection> X11Connection::AcquireShared()
+		{
+			//Weak, so the display is closed once the last window using it is destroyed
+			static std::weak_ptr<X11Connection> shared;
+
+			std::shared_ptr<X11Connection> connection = shared.lock();
+			if (!connection)
+			{
+				connection = std::make_shared<X11Connection>();
+				shared = connection;
+			}
+
+			return connection;
+		}
+
+		inline void X11Connection::Pump()
+		{
+			while (XPending(m_Display))
+			{
+				XEvent event;
+				XNextEvent(m_Display, &event);
+
+				//Events can still arrive for a window that was just destroyed
+				auto found = m_Windows.find(event.xany.window);
+				if (found != m_Windows.end())
+				{
+					found->second->ProcessNativeEvent(event);
+				}
+			}
+		}
+
+		inline void X11NativeWindow::PollEvents()
+		{
+			//A callback may destroy the last window on the connection, which would close the display mid-pump
+			std::shared_ptr<X11Connection> connection = m_Connection;
+			connection->Pump();
+		}
+
+		inline void X11NativeWindow::ProcessNativeEvent(XEvent& event)
+		{
+			Event windowEvent;
+
+			switch (event.type)
+			{
+			case KeyPress:
+			case KeyRelease:
+			{
+				const bool isPressed = (event.type == KeyPress);
+				const KeySym keySym = XLookupKeysym(&event.xkey, 0);
+
+				windowEvent.Type = EventType::Key;
+				windowEvent.Key.Key = ConvertNativeKeyCodes(static_cast<int>(keySym));
+				windowEvent.Key.IsPressed = isPressed;
+				DispatchEvent(windowEvent);
+
+				//Character input is only produced on press, the same as WM_CHAR
+				if (isPressed)
+				{
+					char buffer[16];
+					const int length = XLookupString(&event.xkey, buffer, sizeof(buffer), nullptr, nullptr);
+
+					windowEvent.Type = EventType::Character;
+					for (int i = 0; i < length; ++i)
+					{
+						windowEvent.Character.Character = buffer[i];
+						DispatchEvent(windowEvent);
+					}
+				}
+				break;
+			}
+			case ButtonPress:
+			case ButtonRelease:
+			{
+				//X11 reports the wheel as buttons 4-7, one press per notch
+				if (event.xbutton.button >= Button4 && event.xbutton.button <= 7)
+				{
+					if (event.type == ButtonPress)
+					{
+						const unsigned int wheel = event.xbutton.button;
+
+						windowEvent.Type = EventType::MouseScroll;
+						windowEvent.Scroll.X = (wheel == 6) ? -1.0f : (wheel == 7) ? 1.0f : 0.0f;
+						windowEvent.Scroll.Y = (wheel == Button4) ? 1.0f : (wheel == Button5) ? -1.0f : 0.0f;
+						DispatchEvent(windowEvent);
+					}
+					break;
+				}
+
+				MouseButton button = MouseButton::Unknown;
+				if (event.xbutton.button == Button1)
+				{
+					button = MouseButton::LeftMouseButton;
+				}
+				else if (event.xbutton.button == Button2)
+				{
+					button = MouseButton::MiddleMouseButton;
+				}
+				else if (event.xbutton.button == Button3)
+				{
+					button = MouseButton::RightMouseButton;
+				}
+
+				if (button != MouseButton::Unknown)
+				{
+					windowEvent.Type = EventType::MouseButton;
+					windowEvent.Button.Button = button;
+					windowEvent.Button.IsPressed = (event.type == ButtonPress);
+					DispatchEvent(windowEvent);
+				}
+				break;
+			}
+			case MotionNotify:
+				windowEvent.Type = EventType::MouseMove;
+				windowEvent.Motion.X = event.xmotion.x;
+				windowEvent.Motion.Y = event.xmotion.y;
+				windowEvent.Motion.Time = ConvertEventTime(static_cast<uint32_t>(event.xmotion.time));
+				DispatchEvent(windowEvent);
+				break;
+			case ConfigureNotify:
+				//ConfigureNotify is also sent for moves and restacking, only report actual size changes
+				if (event.xconfigure.width != m_Width || event.xconfigure.height != m_Height)
+				{
+					m_Width = event.xconfigure.width;
+					m_Height = event.xconfigure.height;
+
+					windowEvent.Type = EventType::Resize;
+					windowEvent.Size.Width = event.xconfigure.width;
+					windowEvent.Size.Height = event.xconfigure.height;
+					DispatchEvent(windowEvent);
+				}
+				break;
+			case ClientMessage:
+				if (static_cast<Atom>(event.xclient.data.l[0]) == m_DeleteWindowAtom)
+				{
+					windowEvent.Type = EventType::Close;
+					DispatchEvent(windowEvent);
+				}
+				break;
+			default:
+				break;
+			}
+		}
 
-			virtual void Destroy() override;
+		inline void X11NativeWindow::RefreshScreen()
+		{
+			if (m_UseEGL)
+			{
+				if (m_EGL.Surface != EGL_NO_SURFACE)
+				{
+					eglSwapBuffers(m_EGL.Display, m_EGL.Surface);
+				}
+				return;
+			}
 
-			virtual void PollEvents() override;
-			virtual void RefreshScreen() override;
+			glXSwapBuffers(m_Display, m_WindowHandle);
+		}
 
-			virtual KeyCode ConvertNativeKeyCodes(int key) override;
+		inline void X11NativeWindow::MakeContextCurrent()
+		{
+			if (m_OpenGLContext)
+			{
+				glXMakeCurrent(m_Display, m_WindowHandle, m_OpenGLContext);
+			}
+			else if (m_EGL.Context != EGL_NO_CONTEXT)
+			{
+				eglMakeCurrent(m_EGL.Display, m_EGL.Surface, m_EGL.Surface, m_EGL.Context);
+			}
+		}
 
-			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false) override;
+		inline void* X11NativeWindow::GetNativeContext() const
+		{
+			return m_UseEGL ? static_cast<void*>(m_EGL.Context) : static_cast<void*>(m_OpenGLContext);
+		}
 
-			virtual void* GetExternalAddress(const char* name) override;
+		inline void X11NativeWindow::WaitForEvents(double timeout)
+		{
+			//Events already read into Xlib's queue would not wake poll
+			if (XPending(m_Display))
+				return;
 
+			pollfd descriptors[2] =
+			{
+				{ ConnectionNumber(m_Display), POLLIN, 0 },
+				{ m_WakeEvent, POLLIN, 0 },
+			};
 
+			poll(descriptors, 2, timeout < 0.0 ? -1 : static_cast<int>(timeout * 1000.0));
 
-		private:
-			static void RegisterWindowClass(HINSTANCE hInstance);
-		private:
-			HWND m_WindowHandle;
-			HDC m_DeviceContext;
-			HINSTANCE m_Instance;
-			HGLRC m_OpenGLContext;
-		};
+			//Reset the eventfd counter so the next wait blocks again
+			if (descriptors[1].revents & POLLIN)
+			{
+				uint64_t value;
+				(void)read(m_WakeEvent, &value, sizeof(value));
+			}
+		}
 
-#endif
+		inline void X11NativeWindow::WakeUp()
+		{
+			const uint64_t value = 1;
+			(void)write(m_WakeEvent, &value, sizeof(value));
+		}
 
-#ifdef __linux__
-		class X11NativeWindow : public NativeWindow
+		//Latin-1 keysyms (0x0000 - 0x00FF) to KeyCode
+		inline constexpr KeyTable MakeX11LatinKeyTable()
 		{
-		public:
-			X11NativeWindow(const WindowPtr& window);
+			KeyTable table = {};
 
-			~X11NativeWindow() = default;
+			table.MapRange(XK_a, 26, KeyCode::A);
+			table.MapRange(XK_A, 26, KeyCode::A);
+			table.MapRange(XK_0, 10, KeyCode::Num0);
 
-			virtual void Destroy() override;
+			table.Keys[XK_space] = KeyCode::Space;
 
-			virtual void PollEvents() override;
-			virtual void RefreshScreen() override;
+			table.Keys[XK_grave] = KeyCode::Grave;				table.Keys[XK_minus] = KeyCode::Minus;
+			table.Keys[XK_equal] = KeyCode::Equal;				table.Keys[XK_bracketleft] = KeyCode::LeftBracket;
+			table.Keys[XK_bracketright] = KeyCode::RightBracket;	table.Keys[XK_backslash] = KeyCode::Backslash;
+			table.Keys[XK_semicolon] = KeyCode::Semicolon;		table.Keys[XK_apostrophe] = KeyCode::Apostrophe;
+			table.Keys[XK_comma] = KeyCode::Comma;				table.Keys[XK_period] = KeyCode::Period;
+			table.Keys[XK_slash] = KeyCode::Slash;
 
-			virtual KeyCode ConvertNativeKeyCodes(int key) override;
+			return table;
+		}
 
-			virtual void CreateContext(int major = 4, int minor = 6, bool legacy = false) override;
+		//Function keysyms (0xFF00 - 0xFFFF) to KeyCode, indexed by the low byte
+		inline constexpr KeyTable MakeX11FunctionKeyTable()
+		{
+			KeyTable table = {};
+
+			table.Keys[XK_Escape & 0xFF] = KeyCode::Escape;		table.Keys[XK_Return & 0xFF] = KeyCode::Enter;
+			table.Keys[XK_BackSpace & 0xFF] = KeyCode::Backspace;	table.Keys[XK_Tab & 0xFF] = KeyCode::Tab;
+
+			table.Keys[XK_Shift_L & 0xFF] = KeyCode::Shift;		table.Keys[XK_Shift_R & 0xFF] = KeyCode::Shift;
+			table.Keys[XK_Control_L & 0xFF] = KeyCode::Ctrl;	table.Keys[XK_Control_R & 0xFF] = KeyCode::Ctrl;
+			table.Keys[XK_Alt_L & 0xFF] = KeyCode::Alt;			table.Keys[XK_Alt_R & 0xFF] = KeyCode::Alt;
+			table.Keys[XK_Super_L & 0xFF] = KeyCode::Super;		table.Keys[XK_Super_R & 0xFF] = KeyCode::Super;
+			table.Keys[XK_Menu & 0xFF] = KeyCode::Menu;
+
+			table.Keys[XK_Left & 0xFF] = KeyCode::Left;			table.Keys[XK_Right & 0xFF] = KeyCode::Right;
+			table.Keys[XK_Up & 0xFF] = KeyCode::Up;				table.Keys[XK_Down & 0xFF] = KeyCode::Down;
+
+			table.MapRange(XK_F1 & 0xFF, 12, KeyCode::F1);
+			table.MapRange(XK_F13 & 0xFF, 12, KeyCode::F13);
+
+			table.Keys[XK_Caps_Lock & 0xFF] = KeyCode::CapsLock;	table.Keys[XK_Scroll_Lock & 0xFF] = KeyCode::ScrollLock;
+			table.Keys[XK_Num_Lock & 0xFF] = KeyCode::NumLock;		table.Keys[XK_Print & 0xFF] = KeyCode::PrintScreen;
+			table.Keys[XK_Pause & 0xFF] = KeyCode::Pause;			table.Keys[XK_Insert & 0xFF] = KeyCode::Insert;
+			table.Keys[XK_Delete & 0xFF] = KeyCode::Delete;			table.Keys[XK_Home & 0xFF] = KeyCode::Home;
+			table.Keys[XK_End & 0xFF] = KeyCode::End;				table.Keys[XK_Prior & 0xFF] = KeyCode::PageUp;
+			table.Keys[XK_Next & 0xFF] = KeyCode::PageDown;
+
+			//Keypad keys are looked up without modifiers, so both the digit and the navigation keysym are mapped
+			table.MapRange(XK_KP_0 & 0xFF, 10, KeyCode::Keypad0);
+			table.Keys[XK_KP_Insert & 0xFF] = KeyCode::Keypad0;	table.Keys[XK_KP_End & 0xFF] = KeyCode::Keypad1;
+			table.Keys[XK_KP_Down & 0xFF] = KeyCode::Keypad2;	table.Keys[XK_KP_Next & 0xFF] = KeyCode::Keypad3;
+			table.Keys[XK_KP_Left & 0xFF] = KeyCode::Keypad4;	table.Keys[XK_KP_Begin & 0xFF] = KeyCode::Keypad5;
+			table.Keys[XK_KP_Right & 0xFF] = KeyCode::Keypad6;	table.Keys[XK_KP_Home & 0xFF] = KeyCode::Keypad7;
+			table.Keys[XK_KP_Up & 0xFF] = KeyCode::Keypad8;		table.Keys[XK_KP_Prior & 0xFF] = KeyCode::Keypad9;
+
+			table.Keys[XK_KP_Decimal & 0xFF] = KeyCode::KeypadDecimal;		table.Keys[XK_KP_Delete & 0xFF] = KeyCode::KeypadDecimal;
+			table.Keys[XK_KP_Divide & 0xFF] = KeyCode::KeypadDivide;		table.Keys[XK_KP_Multiply & 0xFF] = KeyCode::KeypadMultiply;
+			table.Keys[XK_KP_Subtract & 0xFF] = KeyCode::KeypadSubtract;	table.Keys[XK_KP_Add & 0xFF] = KeyCode::KeypadAdd;
+			table.Keys[XK_KP_Enter & 0xFF] = KeyCode::KeypadEnter;			table.Keys[XK_KP_Equal & 0xFF] = KeyCode::KeypadEqual;
+
+			return table;
+		}
 
-			virtual void* GetExternalAddress(const char* name) override;
-		private:
-			Display* m_Display;
-		};
-#endif
+		inline KeyCode X11NativeWindow::TranslateKey(int key)
+		{
+			static constexpr KeyTable latinTable = MakeX11LatinKeyTable();
+			static constexpr KeyTable functionTable = MakeX11FunctionKeyTable();
 
-	} //Namespace Internal
+			if (key >= 0 && key <= 0xFF)
+			{
+				return latinTable.Keys[key];
+			}
 
+			if ((key & ~0xFF) == 0xFF00)
+			{
+				return functionTable.Keys[key & 0xFF];
+			}
 
-	//Class Implementations
+			return KeyCode::Unknown;
+		}
 
-	//Public
+		inline void X11NativeWindow::CreateContext(int major, int minor, bool legacy, void* shareContext)
+		{
+			if (m_UseEGL)
+			{
+				CreateEGLContext(major, minor, legacy, static_cast<EGLContext>(shareContext));
+				return;
+			}
 
-#pragma region Window
+			GLXContext glContext = CreateGLXContext(major, minor, legacy, static_cast<GLXContext>(shareContext));
 
-	inline WindowPtr Window::Create(const WindowDescription& description)
-	{
+			if (!glContext)
+			{
+				SW_LOG_ERROR("There was an error creating the OpenGL context");
+				return;
+			}
 
-		auto window = std::make_shared<Window>();
-		window->m_WindowDescription = description;
+			glXMakeCurrent(m_Display, m_WindowHandle, glContext);
+			m_OpenGLContext = glContext;
+			m_ContextVersion = { major, minor, legacy };
 
-		window->m_NativeWindow = Internal::NativeWindow::Create(window);
+			//Query swap control support
+			const char* extensions = glXQueryExtensionsString(m_Display, DefaultScreen(m_Display));
+			if (HasExtension(extensions, "GLX_EXT_swap_control"))
+			{
+				m_SwapIntervalEXT = (void(*)(Display*, GLXDrawable, int))GetExternalAddress("glXSwapIntervalEXT");
+			}
+			else if (HasExtension(extensions, "GLX_MESA_swap_control"))
+			{
+				m_SwapIntervalMESA = (int(*)(unsigned int))GetExternalAddress("glXSwapIntervalMESA");
+			}
 
-		window->m_IsRunning = true;
+			m_SwapIntervalSupport.Interval = (m_SwapIntervalEXT || m_SwapIntervalMESA);
+			m_SwapIntervalSupport.Adaptive = m_SwapIntervalEXT && HasExtension(extensions, "GLX_EXT_swap_control_tear");
+		}
 
-		Internal::Logger::Log("Created Window");
+		inline GLXContext X11NativeWindow::CreateGLXContext(int major, int minor, bool legacy, GLXContext shareContext)
+		{
+			GLXContext glContext = nullptr;
 
-		return window; //Return the parent window
-	}
+			//An unsupported version makes the X server raise BadMatch, which would otherwise terminate the process
+			int (*previousHandler)(Display*, XErrorEvent*) = XSetErrorHandler(IgnoreErrorHandler);
 
-	inline void Window::Destroy() const
-	{
-		m_NativeWindow->Destroy();
-		Internal::Logger::Log("Destroyed Window");
-	}
+			if (legacy)
+			{
+				//Creates OpenGL version 1.x or earlier
+				glContext = glXCreateNewContext(m_Display, m_FrameBufferConfig, GLX_RGBA_TYPE, shareContext, True);
+			}
+			else
+			{
+				//Creates Modern OpenGL version
 
-	inline bool Window::GetIsRunning() const
-	{
-		return m_IsRunning;
-	}
+				//Load glXCreateContextAttribsARB
+				PFNGLXCREATECONTEXTATTRIBSARBPROC glXCreateContextAttribsARB =
+					(PFNGLXCREATECONTEXTATTRIBSARBPROC)GetExternalAddress("glXCreateContextAttribsARB");
 
-	inline void Window::SetIsRunning(bool value)
-	{
-		m_IsRunning = value;
-	}
+				if (!glXCreateContextAttribsARB)
+				{
+					XSetErrorHandler(previousHandler);
+					SW_LOG_ERROR("Context Creation Failed: glXCreateContextAttribsARB is not available");
+					return nullptr;
+				}
 
-	inline void Window::CreateContext(int major, int minor, bool legacy) const
-	{
-		m_NativeWindow->CreateContext(major, minor, legacy);
-	}
+				//Specify the OpenGL specifications
+				const int attribs[] =
+				{
+					GLX_CONTEXT_MAJOR_VERSION_ARB, major,
+					GLX_CONTEXT_MINOR_VERSION_ARB, minor,
+					GLX_CONTEXT_PROFILE_MASK_ARB, GLX_CONTEXT_CORE_PROFILE_BIT_ARB,
+					GLX_CONTEXT_FLAGS_ARB, GLX_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
+					None,
+				};
 
-	inline void Window::PollEvents() const
-	{
-		m_NativeWindow->PollEvents();
-	}
+				//Create the modern OpenGL context
+				glContext = glXCreateContextAttribsARB(m_Display, m_FrameBufferConfig, shareContext, True, attribs);
+			}
 
-	inline char* Window::GetProcAddress(const char* name) const
-	{
-		return static_cast<char*>(m_NativeWindow->GetExternalAddress(name));
-	}
+			//Make sure any error raised during creation has been delivered before restoring the handler
+			XSync(m_Display, False);
+			XSetErrorHandler(previousHandler);
 
-	inline void Window::SetWindowResizeCallback(WindowResizeCallback callback)
-	{
-		m_WindowCallbacks.WindowResizeCallback = std::move(callback);
-	}
+			return glContext;
+		}
 
-	inline void Window::SetWindowKeyCallback(WindowKeyCallback callback)
-	{
-		m_WindowCallbacks.WindowKeyCallback = std::move(callback);
-	}
+		inline void X11NativeWindow::CreateEGLContext(int major, int minor, bool legacy, EGLContext shareContext)
+		{
+			if (!eglBindAPI(EGL_OPENGL_API))
+			{
+				SW_LOG_ERROR("Context Creation Failed: EGL does not support desktop OpenGL");
+				return;
+			}
 
-	inline void Window::SetWindowMouseCallback(WindowMouseCallback callback)
-	{
-		m_WindowCallbacks.WindowMouseCallback = std::move(callback);
-	}
+			m_EGL.Surface = eglCreateWindowSurface(m_EGL.Display, m_EGL.Config, (EGLNativeWindowType)m_WindowHandle, nullptr);
+			if (m_EGL.Surface == EGL_NO_SURFACE)
+			{
+				SW_LOG_ERROR("Context Creation Failed: Could not create the EGL window surface");
+				return;
+			}
 
-	inline void Window::SetWindowMouseMoveCallback(WindowMouseMoveCallback callback)
-	{
-		m_WindowCallbacks.WindowMouseMoveCallback = std::move(callback);
-	}
+			EGLContext glContext = m_EGL.CreateContext(major, minor, legacy, shareContext);
+			if (glContext == EGL_NO_CONTEXT)
+			{
+				SW_LOG_ERROR("There was an error creating the OpenGL context");
+				eglDestroySurface(m_EGL.Display, m_EGL.Surface);
+				m_EGL.Surface = EGL_NO_SURFACE;
+				return;
+			}
 
-	inline void Window::SetWindowCharacterCallback(WindowCharacterCallback callback)
-	{
-		m_WindowCallbacks.WindowCharacterCallback = std::move(callback);
-	}
+			eglMakeCurrent(m_EGL.Display, m_EGL.Surface, m_EGL.Surface, glContext);
+			m_EGL.Context = glContext;
+			m_ContextVersion = { major, minor, legacy };
 
-	inline void Window::SetWindowCloseCallback(WindowCloseCallback callback)
-	{
-		m_WindowCallbacks.WindowCloseCallback = callback;
-	}
+			//eglSwapInterval is core EGL but has no adaptive mode
+			m_SwapIntervalSupport.Interval = true;
+			m_SwapIntervalSupport.Adaptive = false;
+		}
 
-	inline void Window::SetWindowSize(int width, int height)
-	{
-		m_WindowDescription.Width = width;
-		m_WindowDescription.Height = height;
-	}
+		inline SharedContextPtr X11NativeWindow::CreateWorkerContext()
+		{
+			if (m_UseEGL)
+				return m_EGL.CreateWorkerContext(m_ContextVersion.Major, m_ContextVersion.Minor, m_ContextVersion.Legacy);
 
-	inline void Window::SwapBuffers() const
-	{
-		m_NativeWindow->RefreshScreen();
-	}
-#pragma endregion
+			if (!m_OpenGLContext)
+				return nullptr;
 
-	//Private
-	namespace Internal
-	{
-		inline void Logger::Log(const std::string& message)
-		{
-			std::cout << message << "\n";
+			GLXContext glContext = CreateGLXContext(m_ContextVersion.Major, m_ContextVersion.Minor, m_ContextVersion.Legacy, m_OpenGLContext);
+			if (!glContext)
+				return nullptr;
+
+			//OpenGL 3.0+ contexts can be current without a drawable. Older ones bind the window, which GLX allows
+			//to be current in several contexts at once.
+			const GLXDrawable drawable = m_ContextVersion.Legacy ? m_WindowHandle : None;
+			return SharedContextPtr(new X11SharedContext(m_Connection, glContext, drawable));
 		}
 
-		inline NativeWindowPtr NativeWindow::Create(const WindowPtr& window)
+		inline bool X11NativeWindow::SetSwapInterval(int interval)
 		{
-#ifdef _WIN32
-			return std::make_shared<Win32NativeWindow>(window);
-#endif
-		}
+			if (m_UseEGL)
+				return m_EGL.Surface != EGL_NO_SURFACE && eglSwapInterval(m_EGL.Display, interval) == EGL_TRUE;
 
-#pragma region Render
+			if (m_SwapIntervalEXT)
+			{
+				m_SwapIntervalEXT(m_Display, m_WindowHandle, interval);
+				return true;
+			}
 
-		inline void RenderContext::SetViewportSize(int width, int height)
-		{
-			glViewport(0, 0, width, height);
+			//GLX_MESA_swap_control has no adaptive mode, so negative intervals never reach here
+			return m_SwapIntervalMESA && m_SwapIntervalMESA(static_cast<unsigned int>(interval)) == 0;
 		}
 
-		inline void RenderContext::Clear()
+		inline void* X11NativeWindow::GetExternalAddress(const char* name)
 		{
-
-			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-			glClearColor(0.0f, 0.0f, 0.0f, 1);
+			void* proc = m_UseEGL ? (void*)eglGetProcAddress(name) : (void*)glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name));
+			return proc ? proc : GLLibrary::GetSymbol(name);
 		}
 
-		inline void RenderContext::DrawQuad(float x, float y, float scale, Colour colour)
+		inline int X11NativeWindow::IgnoreErrorHandler(Display* display, XErrorEvent* event)
 		{
-			// Enable blending for transparency
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-			// Set up the translation and scaling transformations
-			glPushMatrix();  // Save the current transformation matrix
-
-			glTranslatef(x, y, 0.0f);  // Translate the quad to position (x, y)
-			glScalef(scale, scale, 1.0f);  // Scale the quad by 'scale'
-
-			// Set the color with an alpha value for transparency
-			glColor4f(colour.R, colour.G, colour.B, colour.A);  // Red color with 25% opacity
-
-			// Draw the quad
-			glBegin(GL_QUADS);
-			glVertex3f(-1.0f, -1.0f, 0.0f); // Bottom left
-			glVertex3f(1.0f, -1.0f, 0.0f);  // Bottom right
-			glVertex3f(1.0f, 1.0f, 0.0f);   // Top right
-			glVertex3f(-1.0f, 1.0f, 0.0f);  // Top left
-			glEnd();
-
-			// Restore the previous transformation matrix
-			glPopMatrix();
-
-			// Disable blending if it's not needed for other objects
-			glDisable(GL_BLEND);
+			return 0;
 		}
 
+#endif
 
-#pragma endregion
+		//EGL
 
+#ifdef __linux__
+		// These values come from the EGL 1.5 and EGL_MESA_platform_surfaceless specifications
 
-#ifdef _WIN32
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
 
-		//OpenGL
+		inline bool EGLState::Initialize(EGLenum platform, void* nativeDisplay)
+		{
+			PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT =
+				(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
 
-		typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
+			if (eglGetPlatformDisplayEXT)
+			{
+				Display = eglGetPlatformDisplayEXT(platform, nativeDisplay, nullptr);
+			}
 
-		// These values come from the OpenGL and WGL extension specifications
+			//Older EGL implementations only know the display of their default platform
+			if (Display == EGL_NO_DISPLAY)
+			{
+				Display = eglGetDisplay((EGLNativeDisplayType)nativeDisplay);
+			}
 
-#define WGL_CONTEXT_MAJOR_VERSION_ARB 0x2091
-#define WGL_CONTEXT_MINOR_VERSION_ARB 0x2092
-#define WGL_CONTEXT_LAYER_PLANE_ARB   0x2093
-#define WGL_CONTEXT_FLAGS_ARB         0x2094
-#define WGL_CONTEXT_PROFILE_MASK_ARB  0x9126
+			if (Display == EGL_NO_DISPLAY || !eglInitialize(Display, nullptr, nullptr))
+			{
+				Display = EGL_NO_DISPLAY;
+				return false;
+			}
 
-// Values for WGL_CONTEXT_FLAGS_ARB
-#define WGL_CONTEXT_DEBUG_BIT_ARB              0x0001
-#define WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB 0x0002
+			AddDisplayUser(Display, 1);
+			return true;
+		}
 
-// Values for WGL_CONTEXT_PROFILE_MASK_ARB
-#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB		  0x0001
-#define WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x0002
+		inline bool EGLState::ChooseConfig(EGLint surfaceType)
+		{
+			const EGLint configAttribs[] =
+			{
+				EGL_SURFACE_TYPE, surfaceType,
+				EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+				EGL_RED_SIZE, 8,
+				EGL_GREEN_SIZE, 8,
+				EGL_BLUE_SIZE, 8,
+				EGL_ALPHA_SIZE, 8,
+				EGL_DEPTH_SIZE, 24,
+				EGL_STENCIL_SIZE, 8,
+				EGL_NONE
+			};
 
+			EGLint configCount = 0;
+			return eglChooseConfig(Display, configAttribs, &Config, 1, &configCount) && configCount > 0;
+		}
 
-		inline Win32NativeWindow::Win32NativeWindow(const WindowPtr& window)
+		inline EGLContext EGLState::CreateContext(int major, int minor, bool legacy, EGLContext shareContext) const
 		{
-			m_Window = window;
+			if (legacy)
+			{
+				//Creates OpenGL version 1.x or earlier
+				return eglCreateContext(Display, Config, shareContext, nullptr);
+			}
 
-			m_Instance = GetModuleHandle(nullptr);
+			//Specify the OpenGL specifications
+			const EGLint attribs[] =
+			{
+				EGL_CONTEXT_MAJOR_VERSION, major,
+				EGL_CONTEXT_MINOR_VERSION, minor,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE,
+				EGL_NONE
+			};
 
-			RegisterWindowClass(m_Instance);
+			//Create the modern OpenGL context
+			return eglCreateContext(Display, Config, shareContext, attribs);
+		}
 
-			//Defines the window size
-			RECT rect = { 0, 0, m_Window->GetWindowDescription().Width, m_Window->GetWindowDescription().Height };
-			AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
+		inline SharedContextPtr EGLState::CreateWorkerContext(int major, int minor, bool legacy) const
+		{
+			if (Context == EGL_NO_CONTEXT)
+				return nullptr;
 
-			//Create a temp title to avoid assertion
-			const auto title = m_Window->GetWindowDescription().Title;
-			const std::wstring wtitle(title.begin(), title.end());
+			EGLContext glContext = CreateContext(major, minor, legacy, Context);
+			if (glContext == EGL_NO_CONTEXT)
+				return nullptr;
+
+			//Without surfaceless contexts the worker needs a drawable of its own
+			EGLSurface surface = EGL_NO_SURFACE;
+			if (!HasExtension(eglQueryString(Display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+			{
+				const EGLint surfaceAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+				surface = eglCreatePbufferSurface(Display, Config, surfaceAttribs);
+			}
 
+			return SharedContextPtr(new EGLSharedContext(Display, glContext, surface));
+		}
 
-			//Creates the main application window
-			m_WindowHandle = CreateWindowEx(
-				0, L"SwindowWindowClass",
-				wtitle.c_str(),
-				WS_OVERLAPPEDWINDOW,
-				CW_USEDEFAULT, CW_USEDEFAULT, rect.right - rect.left, rect.bottom - rect.top,
-				nullptr, nullptr, m_Instance, m_Window.get()
-			);
+		inline void EGLState::Destroy()
+		{
+			if (Display == EGL_NO_DISPLAY)
+				return;
 
-			if (!m_WindowHandle)
+			if (Context != EGL_NO_CONTEXT)
 			{
-				DWORD error = GetLastError();
-				wchar_t errorMsg[256];
-				FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, error, 0, errorMsg, 256, nullptr);
-				MessageBox(nullptr, errorMsg, L"CreateWindowEx Failed", MB_ICONERROR | MB_OK);
+				if (eglGetCurrentContext() == Context)
+				{
+					eglMakeCurrent(Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+				}
 
-				return;
+				eglDestroyContext(Display, Context);
+				Context = EGL_NO_CONTEXT;
 			}
 
-			//Pass the window pointer to the WindowProc function
-			SetWindowLongPtr(m_WindowHandle, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
-
-			m_DeviceContext = GetDC(m_WindowHandle);
+			if (Surface != EGL_NO_SURFACE)
+			{
+				eglDestroySurface(Display, Surface);
+				Surface = EGL_NO_SURFACE;
+			}
 
-			ShowWindow(m_WindowHandle, SW_SHOW);
-			UpdateWindow(m_WindowHandle);
+			if (AddDisplayUser(Display, -1) == 0)
+			{
+				eglTerminate(Display);
+			}
+			Display = EGL_NO_DISPLAY;
 		}
 
-
-		inline void Win32NativeWindow::Destroy()
+		inline int EGLState::AddDisplayUser(EGLDisplay display, int delta)
 		{
-			wglMakeCurrent(nullptr, nullptr);
-			wglDeleteContext(m_OpenGLContext);
+			static std::mutex mutex;
+			static std::unordered_map<EGLDisplay, int> users;
 
-			ReleaseDC(m_WindowHandle, m_DeviceContext);
-			DestroyWindow(m_WindowHandle);
+			std::lock_guard<std::mutex> lock(mutex);
+			int& count = users[display];
+			count += delta;
 
-			UnregisterClass(L"SwindowWindowClass", GetModuleHandle(nullptr));
+			const int remaining = count;
+			if (remaining <= 0)
+			{
+				users.erase(display);
+			}
+			return remaining;
+		}
 
+		inline EGLSharedContext::EGLSharedContext(EGLDisplay display, EGLContext context, EGLSurface surface)
+			: m_Display(display), m_Context(context), m_Surface(surface)
+		{
+			EGLState::AddDisplayUser(m_Display, 1);
 		}
 
-		inline void Win32NativeWindow::PollEvents()
+		inline EGLSharedContext::~EGLSharedContext()
 		{
-			MSG msg;
-			while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+			eglDestroyContext(m_Display, m_Context);
+			if (m_Surface != EGL_NO_SURFACE)
 			{
-				TranslateMessage(&msg);
-				DispatchMessage(&msg);
+				eglDestroySurface(m_Display, m_Surface);
+			}
+
+			if (EGLState::AddDisplayUser(m_Display, -1) == 0)
+			{
+				eglTerminate(m_Display);
 			}
 		}
 
-		inline void Win32NativeWindow::RefreshScreen()
+		inline bool EGLSharedContext::MakeCurrent()
 		{
-			SwapBuffers(m_DeviceContext);
+			//The bound API is per thread, and worker threads start out with OpenGL ES
+			return eglBindAPI(EGL_OPENGL_API) && eglMakeCurrent(m_Display, m_Surface, m_Surface, m_Context) == EGL_TRUE;
 		}
 
-		inline KeyCode Win32NativeWindow::ConvertNativeKeyCodes(int key)
+		inline void EGLSharedContext::ReleaseCurrent()
 		{
-			//Setup input map
-			const std::unordered_map<int, KeyCode> keyMap = {
-				{ 'A', KeyCode::A }, { 'B', KeyCode::B }, { 'C', KeyCode::C }, { 'D', KeyCode::D },
-				{ 'E', KeyCode::E }, { 'F', KeyCode::F }, { 'G', KeyCode::G }, { 'H', KeyCode::H },
-				{ 'I', KeyCode::I }, { 'J', KeyCode::J }, { 'K', KeyCode::K }, { 'L', KeyCode::L },
-				{ 'M', KeyCode::M }, { 'N', KeyCode::N }, { 'O', KeyCode::O }, { 'P', KeyCode::P },
-				{ 'Q', KeyCode::Q }, { 'R', KeyCode::R }, { 'S', KeyCode::S }, { 'T', KeyCode::T },
-				{ 'U', KeyCode::U }, { 'V', KeyCode::V }, { 'W', KeyCode::W }, { 'X', KeyCode::X },
-				{ 'Y', KeyCode::Y }, { 'Z', KeyCode::Z },
-
-				{ VK_ESCAPE, KeyCode::Escape }, { VK_RETURN, KeyCode::Enter },
-				{ VK_SPACE, KeyCode::Space },   { VK_BACK, KeyCode::Backspace },
-				{ VK_TAB, KeyCode::Tab },		   { VK_SHIFT, KeyCode::Shift },
-				{ VK_CONTROL, KeyCode::Ctrl },	{ VK_MENU, KeyCode::Alt },
+			eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		}
+#endif
 
-				{ VK_LEFT, KeyCode::Left },		{ VK_RIGHT, KeyCode::Right },
-				{ VK_UP, KeyCode::Up },			{ VK_DOWN, KeyCode::Down },
+		//Headless
 
-				{ VK_F1, KeyCode::F1 },			{ VK_F2, KeyCode::F2 },		{ VK_F3, KeyCode::F3 },
-				{ VK_F4, KeyCode::F4 },			{ VK_F5, KeyCode::F5 },		{ VK_F6, KeyCode::F6 },
-				{ VK_F7, KeyCode::F7 },			{ VK_F8, KeyCode::F8 },		{ VK_F9, KeyCode::F9 },
-				{ VK_F10, KeyCode::F10 },		{ VK_F11, KeyCode::F11 },	{ VK_F12, KeyCode::F12 }
-			};
+		inline HeadlessNativeWindow::HeadlessNativeWindow(Window* window)
+		{
+			m_Window = window;
 
-			auto it = keyMap.find(key);
-			return (it != keyMap.end()) ? it->second : KeyCode::Unknown;
+#ifdef __linux__
+			//Prefer the surfaceless platform so no X server or GPU device is required,
+			//falling back to the default display for older EGL implementations
+			if (!m_EGL.Initialize(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY))
+			{
+				throw Error("Failed to initialize an EGL display for the headless window");
+			}
+#endif
 		}
 
-		inline void Win32NativeWindow::CreateContext(int major, int minor, bool legacy)
+		inline void HeadlessNativeWindow::Destroy()
 		{
-			constexpr PIXELFORMATDESCRIPTOR formatDescriptor =
-			{
-				sizeof(PIXELFORMATDESCRIPTOR),													// Size of the descriptor
-				1,																				// Version number
-				PFD_DRAW_TO_WINDOW |															// Support window drawing
-				PFD_SUPPORT_OPENGL |															// Support OpenGL
-				PFD_DOUBLEBUFFER,																// Enable double buffering
-				PFD_TYPE_RGBA,																	// RGBA color mode
-				32,																				// 32-bit color depth
-				0, 0, 0, 0, 0, 0,              // Ignore color bits
-				0,																				// No alpha buffer
-				0,																				// Ignore shift bit
-				0,																				// No accumulation buffer
-				0, 0, 0, 0,								// Ignore accumulation bits
-				24,																				// 24-bit z-buffer
-				8,																				// 8-bit stencil buffer
-				0,																				// No auxiliary buffer
-				PFD_MAIN_PLANE,																	// Main drawing layer
-				0,																				// Reserved
-		0, 0, 0															// Layer masks ignored
-			};
+			StopEventThread();
 
-			const int format = ChoosePixelFormat(m_DeviceContext, &formatDescriptor);
-			SetPixelFormat(m_DeviceContext, format, &formatDescriptor);
-
-			//Create a dummy context to load extensions
-			HGLRC tempContext = wglCreateContext(m_DeviceContext);
-			wglMakeCurrent(m_DeviceContext, tempContext);
+#ifdef __linux__
+			m_EGL.Destroy();
+#endif
+		}
 
-			//Load wglCreateContextAttrribsARB
-			PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB =
-				(PFNWGLCREATECONTEXTATTRIBSARBPROC)GetExternalAddress("wglCreateContextAttribsARB");
+		inline void HeadlessNativeWindow::PollEvents()
+		{
+			//No display server, so only posted events arrive
+			{
+				std::lock_guard<std::mutex> lock(m_WakeMutex);
+				m_DeliveredEvents.swap(m_PostedEvents);
+			}
 
-			if (!wglCreateContextAttribsARB)
+			for (const Event& event : m_DeliveredEvents)
 			{
-				DWORD error = GetLastError();
-				wchar_t errorMsg[256];
-				int result = swprintf(errorMsg, sizeof(errorMsg), L"Error Code: %lu", error);
-				MessageBox(nullptr, errorMsg, L"Context Creation Failed", MB_ICONERROR);
-				return;
+				DispatchEvent(event);
 			}
+			m_DeliveredEvents.clear();
+		}
 
-			HGLRC glContext;
+		inline void HeadlessNativeWindow::WaitForEvents(double timeout)
+		{
+			//Nothing can arrive from the OS, so only WakeUp and posted events end the wait early
+			std::unique_lock<std::mutex> lock(m_WakeMutex);
 
-			if (legacy)
+			const auto isReady = [this]() { return m_WakeRequested || !m_PostedEvents.empty(); };
+			if (timeout < 0.0)
 			{
-				//Creates OpenGL version 1.x or earlier
-				glContext = wglCreateContext(m_DeviceContext);
+				m_WakeCondition.wait(lock, isReady);
 			}
 			else
 			{
-				//Creates Modern OpenGL version
+				m_WakeCondition.wait_for(lock, std::chrono::duration<double>(timeout), isReady);
+			}
 
-				//Specify the OpenGL specifications
-				const int attribs[] =
-				{
-					WGL_CONTEXT_MAJOR_VERSION_ARB, major,
-					WGL_CONTEXT_MINOR_VERSION_ARB, minor,
-					WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
-					WGL_CONTEXT_FLAGS_ARB, WGL_CONTEXT_FORWARD_COMPATIBLE_BIT_ARB,
-					0,
-				};
+			m_WakeRequested = false;
+		}
 
-				//Create the modern OpenGL context
-				glContext = wglCreateContextAttribsARB(m_DeviceContext, nullptr, attribs);
-			}
+		inline void HeadlessNativeWindow::WakeUp()
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_WakeRequested = true;
+			m_WakeCondition.notify_one();
+		}
 
+		inline bool HeadlessNativeWindow::PostNativeEvent(const Event& event)
+		{
+			std::lock_guard<std::mutex> lock(m_WakeMutex);
+			m_PostedEvents.push_back(event);
+			m_WakeCondition.notify_one();
+			return true;
+		}
 
-			if (!glContext)
+		inline bool HeadlessNativeWindow::ResizeSurface(int width, int height)
+		{
+#ifdef __linux__
+			//Without a context there is no pbuffer yet, and CreateContext uses the size the window has by then
+			if (m_EGL.Surface == EGL_NO_SURFACE)
+				return true;
+
+			if (width <= 0 || height <= 0)
 			{
-				MessageBox(nullptr, L"There was an error creating the OpenGL context", L"Error Creating Context", MB_ICONERROR);
-				wglMakeCurrent(nullptr, nullptr);
-				wglDeleteContext(tempContext);
-				return;
+				SW_LOG_WARNING("Headless window resize to %dx%d rejected: a pbuffer needs a positive size", width, height);
+				return false;
 			}
 
-			//Delete the dummy context
-			wglMakeCurrent(nullptr, nullptr);
-			wglDeleteContext(tempContext);
+			//A pbuffer cannot change size, so create the new one first and keep the old one if that fails
+			const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+			EGLSurface surface = eglCreatePbufferSurface(m_EGL.Display, m_EGL.Config, surfaceAttribs);
+			if (surface == EGL_NO_SURFACE)
+			{
+				SW_LOG_ERROR("Headless window resize to %dx%d rejected: could not create the EGL pbuffer", width, height);
+				return false;
+			}
 
-			wglMakeCurrent(m_DeviceContext, glContext);
-			m_OpenGLContext = glContext;
+			//Rebind if the context is current on this thread; otherwise the next MakeContextCurrent picks the new surface up
+			if (eglGetCurrentContext() == m_EGL.Context)
+			{
+				eglMakeCurrent(m_EGL.Display, surface, surface, m_EGL.Context);
+			}
+
+			eglDestroySurface(m_EGL.Display, m_EGL.Surface);
+			m_EGL.Surface = surface;
+#endif
+			return true;
 		}
 
-		inline void* Win32NativeWindow::GetExternalAddress(const char* name)
+		inline void HeadlessNativeWindow::MakeContextCurrent()
 		{
-			void* proc = (void*)wglGetProcAddress(name);
-			if (!proc)
+#ifdef __linux__
+			if (m_EGL.Context != EGL_NO_CONTEXT)
 			{
-				//If fails we attempt to load the opengl32.dll
-				HMODULE module = LoadLibraryA("opengl32.dll");
-				if (module)
-				{
-					proc = (void*)GetProcAddress(module, name);
-				}
+				eglMakeCurrent(m_EGL.Display, m_EGL.Surface, m_EGL.Surface, m_EGL.Context);
 			}
-			return proc;
+#endif
 		}
 
-		inline LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+		inline void HeadlessNativeWindow::RefreshScreen()
 		{
-			Win32NativeWindow* windowPtr = (Win32NativeWindow*)GetWindowLongPtr(hwnd, GWLP_USERDATA);
-
-			//Return the Default if the window we get from the constructor is null. 
-			if (!windowPtr)
+#ifdef __linux__
+			if (m_EGL.Surface != EGL_NO_SURFACE)
 			{
-				return DefWindowProc(hwnd, uMsg, wParam, lParam);
+				eglSwapBuffers(m_EGL.Display, m_EGL.Surface);
 			}
+#endif
+		}
 
-			//Windows message loop
-			switch (uMsg)
+		inline void HeadlessNativeWindow::CreateContext(int major, int minor, bool legacy, void* shareContext)
+		{
+#ifdef __linux__
+			if (!eglBindAPI(EGL_OPENGL_API))
 			{
-			case WM_CHAR:
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowCharacterCallback)
-				{
-					char character = static_cast<char>(wParam);
-
-					if (character == '\b')
-					{
-						windowPtr->GetWindow()->GetWindowCallbacks().WindowCharacterCallback('\b');
-					}
-					else
-					{
-						windowPtr->GetWindow()->GetWindowCallbacks().WindowCharacterCallback(character);
-					}
-				}
-				break;
-			case WM_SIZE:
-				//Window Resize Event
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowResizeCallback)
-				{
-					int width = LOWORD(lParam);
-					int height = HIWORD(lParam);
+				SW_LOG_ERROR("Context Creation Failed: EGL does not support desktop OpenGL");
+				return;
+			}
 
-					windowPtr->GetWindow()->SetWindowSize(width, height);
+			if (!m_EGL.ChooseConfig(EGL_PBUFFER_BIT))
+			{
+				SW_LOG_ERROR("Context Creation Failed: No matching EGL config");
+				return;
+			}
 
-					windowPtr->GetWindow()->GetWindowCallbacks().WindowResizeCallback(width, height);
-				}
-				break;
-			case WM_KEYDOWN:
-			case WM_KEYUP:
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowKeyCallback)
-				{
-					KeyCode key = windowPtr->ConvertNativeKeyCodes(static_cast<int>(wParam));
-					const bool isPressed = (uMsg == WM_KEYDOWN);
+			const EGLint surfaceAttribs[] =
+			{
+				EGL_WIDTH, m_Window->GetWindowDescription().Width,
+				EGL_HEIGHT, m_Window->GetWindowDescription().Height,
+				EGL_NONE
+			};
 
-					windowPtr->GetWindow()->GetWindowCallbacks().WindowKeyCallback(key, isPressed);
-				}
-				break;
-			case WM_LBUTTONDOWN:
-			case WM_LBUTTONUP:
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseCallback)
-				{
-					MouseButton button = static_cast<MouseButton>(VK_LBUTTON);
-					const bool isPressed = (uMsg == WM_LBUTTONDOWN);
-					windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseCallback(button, isPressed);
-				}
-				break;
-			case WM_RBUTTONDOWN:
-			case WM_RBUTTONUP:
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseCallback)
-				{
-					MouseButton button = static_cast<MouseButton>(VK_RBUTTON);
-					const bool isPressed = (uMsg == WM_LBUTTONDOWN);
-					windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseCallback(button, isPressed);
-				}
-				break;
-			case WM_MOUSEMOVE:
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseMoveCallback)
-				{
-					const int mouseX = LOWORD(lParam);
-					const int mouseY = HIWORD(lParam);
+			m_EGL.Surface = eglCreatePbufferSurface(m_EGL.Display, m_EGL.Config, surfaceAttribs);
+			if (m_EGL.Surface == EGL_NO_SURFACE)
+			{
+				SW_LOG_ERROR("Context Creation Failed: Could not create the EGL pbuffer");
+				return;
+			}
 
-					windowPtr->GetWindow()->GetWindowCallbacks().WindowMouseMoveCallback(mouseX, mouseY);
-				}
-				break;
-			case WM_CLOSE:
-				//If the user has the WindowCloseCallback: Then the application will check if that is true before returning.
-				if (windowPtr->GetWindow()->GetWindowCallbacks().WindowCloseCallback)
-				{
-					if (windowPtr->GetWindow()->GetWindowCallbacks().WindowCloseCallback())
-					{
-						windowPtr->GetWindow()->SetIsRunning(false);
-					}
-					//Continue running the loop if returns false
-				}
-				else
-				{
-					windowPtr->GetWindow()->SetIsRunning(false);
-				}
-				return 0;
-			case WM_DESTROY:
-				PostQuitMessage(0);
-				return 0;
+			EGLContext glContext = m_EGL.CreateContext(major, minor, legacy, static_cast<EGLContext>(shareContext));
 
-			default:
-				return DefWindowProc(hwnd, uMsg, wParam, lParam);
+			if (glContext == EGL_NO_CONTEXT)
+			{
+				SW_LOG_ERROR("There was an error creating the OpenGL context");
+				eglDestroySurface(m_EGL.Display, m_EGL.Surface);
+				m_EGL.Surface = EGL_NO_SURFACE;
+				return;
 			}
 
-			return DefWindowProc(hwnd, uMsg, wParam, lParam);
+			eglMakeCurrent(m_EGL.Display, m_EGL.Surface, m_EGL.Surface, glContext);
+			m_EGL.Context = glContext;
+			m_ContextVersion = { major, minor, legacy };
+#else
+			SW_LOG_ERROR("Context Creation Failed: Headless OpenGL contexts are only supported on Linux");
+#endif
 		}
 
-		inline void Win32NativeWindow::RegisterWindowClass(HINSTANCE hInstance)
+		inline void* HeadlessNativeWindow::GetNativeContext() const
 		{
-			static bool registered = false;
-			if (registered) return;
-
-			WNDCLASSEX wc = {};
-			wc.cbSize = sizeof(WNDCLASSEX);
-			wc.style = CS_HREDRAW | CS_VREDRAW;
-			wc.lpfnWndProc = WindowProc;
-			wc.hInstance = hInstance;
-			wc.hIcon = LoadIcon(nullptr, IDI_APPLICATION);
-			wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
-			wc.hbrBackground = (HBRUSH)(COLOR_WINDOW + 1);
-			wc.lpszClassName = L"SwindowWindowClass";
-			wc.hIconSm = LoadIcon(nullptr, IDI_APPLICATION);
-
-			if (!RegisterClassEx(&wc))
-			{
-				MessageBox(nullptr, L"Failed to register window class", L"Error", MB_ICONERROR | MB_OK);
-			}
-			registered = true;
+#ifdef __linux__
+			return m_EGL.Context;
+#else
+			return nullptr;
+#endif
 		}
 
+		inline SharedContextPtr HeadlessNativeWindow::CreateWorkerContext()
+		{
+#ifdef __linux__
+			return m_EGL.CreateWorkerContext(m_ContextVersion.Major, m_ContextVersion.Minor, m_ContextVersion.Legacy);
+#else
+			return nullptr;
 #endif
+		}
 
-#ifdef __linux__
-		inline X11NativeWindow::X11NativeWindow(const WindowPtr& window)
+		inline void* HeadlessNativeWindow::GetExternalAddress(const char* name)
 		{
-
-		}
+#ifdef __linux__
+			//Without EGL_KHR_get_all_proc_addresses core functions are only available from the library itself
+			void* proc = (void*)eglGetProcAddress(name);
+			return proc ? proc : GLLibrary::GetSymbol(name);
+#else
+			return nullptr;
 #endif
+		}
 
 	}//Namespace Internal
 
@@ -1002,7 +6025,16 @@ namespace Swindow
 
 namespace SwindowImGui
 {
-	static Swindow::WindowPtr g_Window;
+	// Backend data, stored per ImGui context in io.BackendPlatformUserData so every window can have its own context
+	struct ImGui_ImplSwindow_Data
+	{
+		Swindow::WindowPtr Window;
+	};
+
+	static ImGui_ImplSwindow_Data* ImGui_ImplSwindow_GetBackendData()
+	{
+		return ImGui::GetCurrentContext() ? static_cast<ImGui_ImplSwindow_Data*>(ImGui::GetIO().BackendPlatformUserData) : nullptr;
+	}
 
 	static int ConvertKeyCode(Swindow::KeyCode code)
 	{
@@ -1014,9 +6046,13 @@ namespace SwindowImGui
 		if (!window)
 			return false;
 
-		g_Window = window;
-
 		ImGuiIO& io = ImGui::GetIO();
+		IM_ASSERT(io.BackendPlatformUserData == nullptr && "Already initialized a platform backend!");
+
+		ImGui_ImplSwindow_Data* backendData = IM_NEW(ImGui_ImplSwindow_Data)();
+		backendData->Window = window;
+		io.BackendPlatformUserData = backendData;
+		io.BackendPlatformName = "imgui_impl_swindow";
 
 		// Navigation keys
 		io.KeyMap[ImGuiKey_Tab] = ConvertKeyCode(Swindow::KeyCode::Tab);
@@ -1024,12 +6060,12 @@ namespace SwindowImGui
 		io.KeyMap[ImGuiKey_RightArrow] = ConvertKeyCode(Swindow::KeyCode::Right);
 		io.KeyMap[ImGuiKey_UpArrow] = ConvertKeyCode(Swindow::KeyCode::Up);
 		io.KeyMap[ImGuiKey_DownArrow] = ConvertKeyCode(Swindow::KeyCode::Down);
-		io.KeyMap[ImGuiKey_PageUp] =	-1;
-		io.KeyMap[ImGuiKey_PageDown] =	-1;
-		io.KeyMap[ImGuiKey_Home] =		-1;
-		io.KeyMap[ImGuiKey_End] =		-1;
-		io.KeyMap[ImGuiKey_Insert] =	-1;
-		io.KeyMap[ImGuiKey_Delete] =	-1;
+		io.KeyMap[ImGuiKey_PageUp] = ConvertKeyCode(Swindow::KeyCode::PageUp);
+		io.KeyMap[ImGuiKey_PageDown] = ConvertKeyCode(Swindow::KeyCode::PageDown);
+		io.KeyMap[ImGuiKey_Home] = ConvertKeyCode(Swindow::KeyCode::Home);
+		io.KeyMap[ImGuiKey_End] = ConvertKeyCode(Swindow::KeyCode::End);
+		io.KeyMap[ImGuiKey_Insert] = ConvertKeyCode(Swindow::KeyCode::Insert);
+		io.KeyMap[ImGuiKey_Delete] = ConvertKeyCode(Swindow::KeyCode::Delete);
 
 		// Modifier keys
 		io.KeyMap[ImGuiKey_Backspace] = ConvertKeyCode(Swindow::KeyCode::Backspace);
@@ -1038,13 +6074,13 @@ namespace SwindowImGui
 		io.KeyMap[ImGuiKey_Escape] = ConvertKeyCode(Swindow::KeyCode::Escape);
 
 		// Alphabet keys
-		for (char c = 'A'; c <= 'Z'; ++c) {
-			io.KeyMap[ImGuiKey_A + (c - 'A')] = c;
+		for (int i = 0; i < 26; ++i) {
+			io.KeyMap[ImGuiKey_A + i] = ConvertKeyCode(Swindow::KeyCode::A) + i;
 		}
 
 		// Number keys (top row)
-		for (char c = '0'; c <= '9'; ++c) {
-			io.KeyMap[ImGuiKey_0 + (c - '0')] = c;
+		for (int i = 0; i < 10; ++i) {
+			io.KeyMap[ImGuiKey_0 + i] = ConvertKeyCode(Swindow::KeyCode::Num0) + i;
 		}
 
 		// Function keys (F1-F12)
@@ -1062,61 +6098,62 @@ namespace SwindowImGui
 		io.KeyMap[ImGuiKey_F12] = ConvertKeyCode(Swindow::KeyCode::F12);
 
 		// Numpad keys
-		io.KeyMap[ImGuiKey_Keypad0] = ConvertKeyCode(Swindow::KeyCode::Num0);
-		io.KeyMap[ImGuiKey_Keypad1] = ConvertKeyCode(Swindow::KeyCode::Num1);
-		io.KeyMap[ImGuiKey_Keypad2] = ConvertKeyCode(Swindow::KeyCode::Num2);
-		io.KeyMap[ImGuiKey_Keypad3] = ConvertKeyCode(Swindow::KeyCode::Num3);
-		io.KeyMap[ImGuiKey_Keypad4] = ConvertKeyCode(Swindow::KeyCode::Num4);
-		io.KeyMap[ImGuiKey_Keypad5] = ConvertKeyCode(Swindow::KeyCode::Num5);
-		io.KeyMap[ImGuiKey_Keypad6] = ConvertKeyCode(Swindow::KeyCode::Num6);
-		io.KeyMap[ImGuiKey_Keypad7] = ConvertKeyCode(Swindow::KeyCode::Num7);
-		io.KeyMap[ImGuiKey_Keypad8] = ConvertKeyCode(Swindow::KeyCode::Num8);
-		io.KeyMap[ImGuiKey_Keypad9] = ConvertKeyCode(Swindow::KeyCode::Num9);
-		io.KeyMap[ImGuiKey_KeypadEnter] = -1;
+		for (int i = 0; i < 10; ++i) {
+			io.KeyMap[ImGuiKey_Keypad0 + i] = ConvertKeyCode(Swindow::KeyCode::Keypad0) + i;
+		}
+		io.KeyMap[ImGuiKey_KeypadEnter] = ConvertKeyCode(Swindow::KeyCode::KeypadEnter);
 
 		// Special characters
-		io.KeyMap[ImGuiKey_Semicolon] = -1;
-		io.KeyMap[ImGuiKey_Equal] = -1;
-		io.KeyMap[ImGuiKey_Comma] = -1;
-		io.KeyMap[ImGuiKey_Minus] = -1;
-		io.KeyMap[ImGuiKey_Period] = -1;
-		io.KeyMap[ImGuiKey_Slash] = -1;
-		io.KeyMap[ImGuiKey_LeftBracket] = -1;
-		io.KeyMap[ImGuiKey_Backslash] = -1;
+		io.KeyMap[ImGuiKey_Semicolon] = ConvertKeyCode(Swindow::KeyCode::Semicolon);
+		io.KeyMap[ImGuiKey_Equal] = ConvertKeyCode(Swindow::KeyCode::Equal);
+		io.KeyMap[ImGuiKey_Comma] = ConvertKeyCode(Swindow::KeyCode::Comma);
+		io.KeyMap[ImGuiKey_Minus] = ConvertKeyCode(Swindow::KeyCode::Minus);
+		io.KeyMap[ImGuiKey_Period] = ConvertKeyCode(Swindow::KeyCode::Period);
+		io.KeyMap[ImGuiKey_Slash] = ConvertKeyCode(Swindow::KeyCode::Slash);
+		io.KeyMap[ImGuiKey_LeftBracket] = ConvertKeyCode(Swindow::KeyCode::LeftBracket);
+		io.KeyMap[ImGuiKey_Backslash] = ConvertKeyCode(Swindow::KeyCode::Backslash);
 
 		if (install_callbacks) 
 		{
-			g_Window->SetWindowMouseMoveCallback([&](int x, int y)
+			// Each window's callbacks write to the IO of the context that was current when it was initialized
+			ImGuiIO* windowIO = &io;
+
+			window->SetWindowMouseMoveCallback([windowIO](int x, int y)
 				{
-					io.MousePos.x = static_cast<float>(x);
-					io.MousePos.y = static_cast<float>(y);
+					windowIO->MousePos.x = static_cast<float>(x);
+					windowIO->MousePos.y = static_cast<float>(y);
 				});
 
-			g_Window->SetWindowMouseCallback([&](Swindow::MouseButton button, bool isPressed)
+			window->SetWindowMouseCallback([windowIO](Swindow::MouseButton button, bool isPressed)
 				{
 					if (button == Swindow::MouseButton::LeftMouseButton)
 					{
-						io.MouseDown[0] = static_cast<int>(button) && isPressed;
+						windowIO->MouseDown[0] = static_cast<int>(button) && isPressed;
 					}
 
 					if (button == Swindow::MouseButton::RightMouseButton)
 					{
-						io.MouseDown[1] = static_cast<int>(button) && isPressed;
+						windowIO->MouseDown[1] = static_cast<int>(button) && isPressed;
+					}
+
+					if (button == Swindow::MouseButton::MiddleMouseButton)
+					{
+						windowIO->MouseDown[2] = isPressed;
 					}
 				});
 
-			g_Window->SetWindowCharacterCallback([&](char character)
+			window->SetWindowCharacterCallback([windowIO](char character)
 				{
-					io.AddInputCharacter(character);
+					windowIO->AddInputCharacter(character);
 				});
 
-			g_Window->SetWindowKeyCallback([&](Swindow::KeyCode key, bool isPressed)
+			window->SetWindowKeyCallback([windowIO](Swindow::KeyCode key, bool isPressed)
 				{
 					//Get the current ImGui key
 					int imguiKey = ConvertKeyCode(key);
-					if (imguiKey >= 0 && imguiKey < IM_ARRAYSIZE(io.KeysDown)) 
+					if (imguiKey >= 0 && imguiKey < IM_ARRAYSIZE(windowIO->KeysDown)) 
 					{
-						io.KeysDown[imguiKey] = isPressed;
+						windowIO->KeysDown[imguiKey] = isPressed;
 
 					}
 				});
@@ -1127,17 +6164,34 @@ namespace SwindowImGui
 
 	inline void ImGui_ImplSwindow_Shutdown()
 	{
-		g_Window = nullptr;
+		ImGui_ImplSwindow_Data* backendData = ImGui_ImplSwindow_GetBackendData();
+		IM_ASSERT(backendData != nullptr && "No platform backend to shutdown, or already shutdown?");
+
+		ImGuiIO& io = ImGui::GetIO();
+		io.BackendPlatformUserData = nullptr;
+		io.BackendPlatformName = nullptr;
+		IM_DELETE(backendData);
 	}
 
 	inline void ImGui_ImplSwindow_NewFrame()
 	{
+		ImGui_ImplSwindow_Data* backendData = ImGui_ImplSwindow_GetBackendData();
+		IM_ASSERT(backendData != nullptr && "Did you call ImGui_ImplSwindow_InitForOpenGL()?");
+		const Swindow::WindowPtr& window = backendData->Window;
+
 		// Update display size
 		ImGuiIO& io = ImGui::GetIO();
-		io.DisplaySize = ImVec2((float)g_Window->GetWindowDescription().Width, (float)g_Window->GetWindowDescription().Height);
+		io.DisplaySize = ImVec2((float)window->GetWidth(), (float)window->GetHeight());
+
+		// Update mouse wheel, accumulated by the last PollEvents
+		float wheelX, wheelY;
+		window->GetMouseWheel(wheelX, wheelY);
+		io.MouseWheelH += wheelX;
+		io.MouseWheel += wheelY;
 
-		// Update delta time
-		io.DeltaTime = 0.016f;
+		// Update delta time, measured between the window's SwapBuffers calls. ImGui requires a positive value.
+		const float deltaTime = window->GetDeltaTime();
+		io.DeltaTime = deltaTime > 0.0f ? deltaTime : 1.0f / 60.0f;
 	}
 }
 